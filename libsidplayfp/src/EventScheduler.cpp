@@ -22,11 +22,51 @@
 
 #include "EventScheduler.h"
 
+#ifdef EVENT_STATS
+#  include <cstring>
+#endif
+
+
+#ifdef EVENT_HEAP
+
+void EventScheduler::reset()
+{
+    heap.clear();
+    nextSequence = 0;
+    currentTime = 0;
+    limit = 0;
+#ifdef EVENT_STATS
+    firing = nullptr;
+#endif
+}
+
+void EventScheduler::cancel(Event &event)
+{
+    if (queued(event))
+    {
+#ifdef EVENT_STATS
+        countCancel(event);
+#endif
+        remove(event.heapPos);
+    }
+}
+
+bool EventScheduler::isPending(Event &event) const
+{
+    return queued(event);
+}
+
+#else
 
 void EventScheduler::reset()
 {
     firstEvent = nullptr;
     currentTime = 0;
+    limit = 0;
+#ifdef EVENT_STATS
+    firing = nullptr;
+    pending = 0;
+#endif
 }
 
 void EventScheduler::cancel(Event &event)
@@ -37,6 +77,9 @@ void EventScheduler::cancel(Event &event)
     {
         if (&event == *scan)
         {
+#ifdef EVENT_STATS
+            countCancel(event);
+#endif
             *scan = (*scan)->next;
             break;
         }
@@ -57,3 +100,49 @@ bool EventScheduler::isPending(Event &event) const
     }
     return false;
 }
+
+#endif
+
+#ifdef EVENT_STATS
+
+/**
+ * Orders event names alphabetically.
+ */
+struct nameLess
+{
+    bool operator()(const char *a, const char *b) const { return strcmp(a, b) < 0; }
+};
+
+void EventScheduler::getStats(std::vector<EventStats> &result) const
+{
+    // Different instances of the same component use the same name
+    typedef std::map<const char*, stats_t, nameLess> merged_t;
+    merged_t merged;
+
+    for (std::map<const char*, stats_t>::const_iterator it = stats.begin(); it != stats.end(); ++it)
+    {
+        stats_t &s = merged[it->first];
+        s.dispatches += it->second.dispatches;
+        s.schedules += it->second.schedules;
+        s.reschedules += it->second.reschedules;
+        s.cancels += it->second.cancels;
+        s.queueDepth += it->second.queueDepth;
+    }
+
+    result.clear();
+    for (merged_t::const_iterator it = merged.begin(); it != merged.end(); ++it)
+    {
+        EventStats es;
+        es.name = it->first;
+        es.dispatches = it->second.dispatches;
+        es.schedules = it->second.schedules;
+        es.reschedules = it->second.reschedules;
+        es.cancels = it->second.cancels;
+        es.queueDepth = it->second.schedules
+            ? static_cast<double>(it->second.queueDepth) / it->second.schedules
+            : 0.;
+        result.push_back(es);
+    }
+}
+
+#endif
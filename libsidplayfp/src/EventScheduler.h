@@ -24,9 +24,22 @@
 #define EVENTSCHEDULER_H
 
 #include "sidplayfp/event.h"
+#include "chrometrace.h"
 
 #include "sidcxx11.h"
 
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#if defined(EVENT_HEAP) || defined(EVENT_STATS)
+#  include <vector>
+#endif
+
+#ifdef EVENT_STATS
+#  include <map>
+#endif
+
 
 template< class This >
 class EventCallback: public Event
@@ -49,25 +62,322 @@ public:
 };
 
 
+/**
+ * Event context extended with the time skipping
+ * the CPU uses to run ahead while the bus is free.
+ * Internal to the emulation, unlike EventContext.
+ */
+class CpuEventContext : public EventContext
+{
+public:
+    /**
+     * Get how many cycles time can be advanced from within
+     * the event being fired before another event is due.
+     *
+     * @return the number of free cycles
+     */
+    virtual event_clock_t freeCycles() const = 0;
+
+    /**
+     * Advance time from within the event being fired,
+     * as if it had been rescheduled later and fired again.
+     * This is only possible if no other event is due in the meantime.
+     *
+     * @param cycles how many cycles to advance
+     * @return true if time has been advanced
+     */
+    virtual bool advance(unsigned int cycles) = 0;
+
+protected:
+    ~CpuEventContext() {}
+};
+
 /**
  * Fast EventScheduler implementation
  *
+ * Two queue backends are available, selected at build time:
+ * - a sorted linked list (default), very fast for the handful
+ *   of events the emulation keeps pending;
+ * - an indexed binary heap (EVENT_HEAP), with O(log n) insertion and
+ *   removal and O(1) isPending, which scales better with
+ *   the number of pending events. Each pending event keeps
+ *   its heap position in the slot the list uses as link.
+ *
+ * Both backends fire events due at the same clock in the order
+ * they were scheduled, so emulation output is identical.
+ *
+ * With STATIC_EVENT_CONTEXT the class is final and the scheduling
+ * methods are public, so that calls made through an EventScheduler
+ * reference are bound at compile time, see event_context_t.
+ *
  * @author Antti S. Lankila
  */
-class EventScheduler: public EventContext
+#ifdef STATIC_EVENT_CONTEXT
+class EventScheduler final : public CpuEventContext
+#else
+class EventScheduler : public CpuEventContext
+#endif
 {
 private:
+#ifdef EVENT_HEAP
+    /**
+     * A pending event.
+     */
+    struct HeapEntry
+    {
+        /// Copy of the event's trigger time, to keep comparisons local
+        event_clock_t triggerTime;
+
+        /// Scheduling order, to fire events due at the same clock in FIFO order
+        uint_least64_t sequence;
+
+        Event *event;
+    };
+
+    /**
+     * Pending events, a binary min-heap ordered
+     * by trigger time and scheduling order.
+     * Each pending event records its position in Event::heapPos.
+     */
+    std::vector<HeapEntry> heap;
+
+    /**
+     * Sequence number for the next scheduled event.
+     */
+    uint_least64_t nextSequence;
+#else
     /**
      * The first event of the chain.
      */
     Event *firstEvent;
+#endif
 
     /**
      * EventScheduler's current clock.
      */
     event_clock_t currentTime;
 
+    /**
+     * Deadline of the running runUntil call.
+     */
+    event_clock_t limit;
+
+    /**
+     * Tracing sink, null if tracing is disabled.
+     */
+    libsidplayfp::ChromeTrace *trace;
+
+#ifdef EVENT_STATS
+    /**
+     * Statistics collected for each event name.
+     */
+    struct stats_t
+    {
+        uint_least64_t dispatches;
+        uint_least64_t schedules;
+        uint_least64_t reschedules;
+        uint_least64_t cancels;
+        uint_least64_t queueDepth;
+
+        stats_t() :
+            dispatches(0),
+            schedules(0),
+            reschedules(0),
+            cancels(0),
+            queueDepth(0) {}
+    };
+
+    /**
+     * Statistics indexed by the event name pointer.
+     */
+    std::map<const char*, stats_t> stats;
+
+    /**
+     * The event being fired, if any.
+     */
+    const Event *firing;
+
+#  ifndef EVENT_HEAP
+    /**
+     * Number of pending events.
+     */
+    unsigned int pending;
+#  endif
+#endif
+
 private:
+#ifdef EVENT_STATS
+    /**
+     * Update statistics for a scheduled event.
+     */
+    void countSchedule(const Event &event)
+    {
+        stats_t &s = stats[event.m_name];
+        s.schedules++;
+#  ifdef EVENT_HEAP
+        if (&event == firing || queued(event))
+            s.reschedules++;
+        s.queueDepth += heap.size();
+#  else
+        if (&event == firing)
+            s.reschedules++;
+        s.queueDepth += pending++;
+#  endif
+    }
+
+    /**
+     * Update statistics for a cancelled event.
+     */
+    void countCancel(const Event &event)
+    {
+        stats[event.m_name].cancels++;
+#  ifndef EVENT_HEAP
+        pending--;
+#  endif
+    }
+#endif
+
+    /**
+     * Fire an event removed from the queue,
+     * advancing time to it.
+     */
+    void dispatch(Event &event)
+    {
+        currentTime = event.triggerTime;
+        if (trace != nullptr)
+            trace->dispatch(event.m_name);
+#ifdef EVENT_STATS
+        stats[event.m_name].dispatches++;
+#  ifndef EVENT_HEAP
+        pending--;
+#  endif
+        firing = &event;
+        event.event();
+        firing = nullptr;
+#else
+        event.event();
+#endif
+    }
+
+#ifdef EVENT_HEAP
+    /**
+     * Check if entry a must fire before entry b.
+     */
+    static bool earlier(const HeapEntry &a, const HeapEntry &b)
+    {
+        return (a.triggerTime < b.triggerTime)
+            || (a.triggerTime == b.triggerTime && a.sequence < b.sequence);
+    }
+
+    /**
+     * Check if event is in the heap.
+     */
+    bool queued(const Event &event) const
+    {
+        return event.heapPos < heap.size() && heap[event.heapPos].event == &event;
+    }
+
+    /**
+     * Store entry at the given heap position.
+     */
+    void place(const HeapEntry &entry, unsigned int pos)
+    {
+        heap[pos] = entry;
+        entry.event->heapPos = pos;
+    }
+
+    /**
+     * Move the entry at the given position towards the root
+     * until the heap property is restored.
+     */
+    void siftUp(unsigned int pos)
+    {
+        const HeapEntry entry = heap[pos];
+        while (pos > 0)
+        {
+            const unsigned int parent = (pos - 1) >> 1;
+            if (!earlier(entry, heap[parent]))
+                break;
+            place(heap[parent], pos);
+            pos = parent;
+        }
+        place(entry, pos);
+    }
+
+    /**
+     * Move the entry at the given position towards the leaves
+     * until the heap property is restored.
+     */
+    void siftDown(unsigned int pos)
+    {
+        const HeapEntry entry = heap[pos];
+        const unsigned int size = heap.size();
+        for (;;)
+        {
+            unsigned int child = (pos << 1) + 1;
+            if (child >= size)
+                break;
+            if (child + 1 < size && earlier(heap[child + 1], heap[child]))
+                child++;
+            if (!earlier(heap[child], entry))
+                break;
+            place(heap[child], pos);
+            pos = child;
+        }
+        place(entry, pos);
+    }
+
+    /**
+     * Move the entry at the given position to where it belongs.
+     */
+    void restore(unsigned int pos)
+    {
+        if (pos > 0 && earlier(heap[pos], heap[(pos - 1) >> 1]))
+            siftUp(pos);
+        else
+            siftDown(pos);
+    }
+
+    /**
+     * Remove the entry at the given heap position.
+     */
+    void remove(unsigned int pos)
+    {
+        const HeapEntry last = heap.back();
+        heap.pop_back();
+
+        if (pos < heap.size())
+        {
+            place(last, pos);
+            restore(pos);
+        }
+    }
+
+    /**
+     * Insert event in the heap, or move it
+     * if it is already pending.
+     *
+     * @param event The event to add
+     */
+    void schedule(Event &event)
+    {
+#ifdef EVENT_STATS
+        countSchedule(event);
+#endif
+        const HeapEntry entry = { event.triggerTime, nextSequence++, &event };
+        if (queued(event))
+        {
+            const unsigned int pos = event.heapPos;
+            heap[pos] = entry;
+            restore(pos);
+        }
+        else
+        {
+            heap.push_back(entry);
+            siftUp(heap.size() - 1);
+        }
+    }
+#else
     /**
      * Scan the event queue and schedule event for execution.
      *
@@ -75,6 +385,9 @@ private:
      */
     void schedule(Event &event)
     {
+#ifdef EVENT_STATS
+        countSchedule(event);
+#endif
         // find the right spot where to tuck this new event
         Event **scan = &firstEvent;
         for (;;)
@@ -88,8 +401,13 @@ private:
              scan = &((*scan)->next);
          }
     }
+#endif
 
+#ifdef STATIC_EVENT_CONTEXT
+public:
+#else
 protected:
+#endif
     void schedule(Event &event, unsigned int cycles,
                    event_phase_t phase) override
     {
@@ -108,30 +426,126 @@ protected:
 
 public:
     EventScheduler() :
+#ifdef EVENT_HEAP
+        nextSequence(0),
+#else
         firstEvent(nullptr),
-        currentTime(0) {}
+#endif
+        currentTime(0),
+        limit(0),
+        trace(nullptr)
+#ifdef EVENT_STATS
+        , firing(nullptr)
+#  ifndef EVENT_HEAP
+        , pending(0)
+#  endif
+#endif
+    {}
 
     /**
      * Cancel all pending events and reset time.
      */
     void reset();
 
+    /**
+     * Set the tracing sink.
+     *
+     * @param sink the sink, null to disable tracing
+     */
+    void setTrace(libsidplayfp::ChromeTrace *sink) { trace = sink; }
+
     /**
      * Fire next event, advance system time to that event.
      */
     void clock()
     {
+#ifdef EVENT_HEAP
+        Event &event = *heap.front().event;
+        remove(0);
+#else
         Event &event = *firstEvent;
         firstEvent = firstEvent->next;
-        currentTime = event.triggerTime;
-        event.event();
+#endif
+        dispatch(event);
+    }
+
+    /**
+     * Fire all the events due before the specified clock
+     * and advance time to it.
+     *
+     * @param clock the PHI1 clock to run until
+     */
+    void runUntil(event_clock_t clock)
+    {
+        const event_clock_t deadline = clock << 1;
+        limit = deadline;
+#ifdef EVENT_HEAP
+        while (heap.front().triggerTime < deadline)
+        {
+            Event &event = *heap.front().event;
+            remove(0);
+            dispatch(event);
+        }
+#else
+        Event *event = firstEvent;
+        while (event->triggerTime < deadline)
+        {
+            firstEvent = event->next;
+            dispatch(*event);
+            event = firstEvent;
+        }
+#endif
+        if (currentTime < deadline)
+            currentTime = deadline;
+    }
+
+    /**
+     * Fire all the events due in the specified number of cycles.
+     *
+     * @param cycles how many cycles to run
+     */
+    void runCycles(unsigned int cycles)
+    {
+        runUntil(getTime(EVENT_CLOCK_PHI1) + cycles);
     }
 
+#ifdef EVENT_STATS
+    /**
+     * Get the statistics collected so far,
+     * merging events with the same name.
+     *
+     * @param result the vector to fill
+     */
+    void getStats(std::vector<EventStats> &result) const;
+#endif
+
     /**
      * Check if an event is in the queue.
      */
     bool isPending(Event &event) const override;
 
+    event_clock_t freeCycles() const override
+    {
+        event_clock_t next = limit;
+#ifdef EVENT_HEAP
+        if (!heap.empty() && heap.front().triggerTime < next)
+            next = heap.front().triggerTime;
+#else
+        if (firstEvent != nullptr && firstEvent->triggerTime < next)
+            next = firstEvent->triggerTime;
+#endif
+        return next > currentTime ? (next - currentTime - 1) >> 1 : 0;
+    }
+
+    bool advance(unsigned int cycles) override
+    {
+        if (freeCycles() < cycles)
+            return false;
+
+        currentTime += cycles << 1;
+        return true;
+    }
+
     event_clock_t getTime(event_phase_t phase) const override
     {
         return (currentTime + (phase ^ 1)) >> 1;
@@ -145,4 +559,22 @@ public:
     event_phase_t phase() const override { return static_cast<event_phase_t>(currentTime & 1); }
 };
 
+/**
+ * Event context the emulated chips are bound to.
+ *
+ * With STATIC_EVENT_CONTEXT the components hold the concrete
+ * EventScheduler so that scheduling calls on the hot path are
+ * resolved at compile time and inlined, otherwise they go through
+ * the virtual EventContext interface.
+ * EventContext remains the interface exposed to the public API.
+ * The CPU also needs the time skipping of CpuEventContext.
+ */
+#ifdef STATIC_EVENT_CONTEXT
+typedef EventScheduler event_context_t;
+typedef EventScheduler cpu_event_context_t;
+#else
+typedef EventContext event_context_t;
+typedef CpuEventContext cpu_event_context_t;
+#endif
+
 #endif // EVENTSCHEDULER_H
@@ -69,6 +69,11 @@ public:
     uint_least16_t m_driverAddr;
     uint_least16_t m_driverLength;
 
+    uint_least32_t m_playCalls;
+    uint_least32_t m_playCyclesMin;
+    uint_least32_t m_playCyclesAvg;
+    uint_least32_t m_playCyclesMax;
+
 private:
     // prevent copying
     SidInfoImpl(const SidInfoImpl&);
@@ -81,7 +86,11 @@ public:
         m_maxsids(Mixer::MAX_SIDS),
         m_channels(1),
         m_driverAddr(0),
-        m_driverLength(0)
+        m_driverLength(0),
+        m_playCalls(0),
+        m_playCyclesMin(0),
+        m_playCyclesAvg(0),
+        m_playCyclesMax(0)
     {
         m_credits.push_back(PACKAGE_NAME " V" PACKAGE_VERSION " Engine:\n"
             "\tCopyright (C) 2000 Simon White\n"
@@ -108,6 +117,11 @@ public:
     const char *getKernalDesc() const override { return m_kernalDesc.c_str(); }
     const char *getBasicDesc() const override { return m_basicDesc.c_str(); }
     const char *getChargenDesc() const override { return m_chargenDesc.c_str(); }
+
+    uint_least32_t getPlayCalls() const override { return m_playCalls; }
+    uint_least32_t getPlayCyclesMin() const override { return m_playCyclesMin; }
+    uint_least32_t getPlayCyclesAvg() const override { return m_playCyclesAvg; }
+    uint_least32_t getPlayCyclesMax() const override { return m_playCyclesMax; }
 };
 
 #endif  /* SIDTUNEINFOIMPL_H */
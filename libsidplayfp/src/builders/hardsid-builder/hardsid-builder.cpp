@@ -140,6 +140,11 @@ void HardSIDBuilder::filter(bool enable)
     std::for_each(sidobjs.begin(), sidobjs.end(), applyParameter<HardSID, bool>(&HardSID::filter, enable));
 }
 
+void HardSIDBuilder::latency(unsigned int cycles)
+{
+    std::for_each(sidobjs.begin(), sidobjs.end(), applyParameter<HardSID, unsigned int>(&HardSID::latency, cycles));
+}
+
 #ifdef _WIN32
 
 // Load the library and initialise the hardsid
@@ -34,18 +34,6 @@
 #  include "config.h"
 #endif
 
-// Move these to common header file
-#define HSID_IOCTL_RESET     _IOW('S', 0, int)
-#define HSID_IOCTL_FIFOSIZE  _IOR('S', 1, int)
-#define HSID_IOCTL_FIFOFREE  _IOR('S', 2, int)
-#define HSID_IOCTL_SIDTYPE   _IOR('S', 3, int)
-#define HSID_IOCTL_CARDTYPE  _IOR('S', 4, int)
-#define HSID_IOCTL_MUTE      _IOW('S', 5, int)
-#define HSID_IOCTL_NOFILTER  _IOW('S', 6, int)
-#define HSID_IOCTL_FLUSH     _IO ('S', 7)
-#define HSID_IOCTL_DELAY     _IOW('S', 8, int)
-#define HSID_IOCTL_READ      _IOWR('S', 9, int*)
-
 bool HardSID::m_sidFree[16] = {0};
 const unsigned int HardSID::voices = HARDSID_VOICES;
 unsigned int HardSID::sid = 0;
@@ -110,6 +98,8 @@ HardSID::HardSID (sidbuilder *builder) :
         }
     }
 
+    m_queue.setHandle(m_handle);
+
     m_status = true;
     reset();
 }
@@ -119,13 +109,19 @@ HardSID::~HardSID()
     sid--;
     m_sidFree[m_instance] = 0;
     if (m_handle)
+    {
+        m_queue.flush();
         close(m_handle);
+    }
 }
 
 void HardSID::reset(uint8_t volume)
 {
     for (unsigned int i= 0; i < voices; i++)
         muted[i] = false;
+    m_queue.flush();
+    m_queue.clear();
+    checkQueue();
     ioctl(m_handle, HSID_IOCTL_RESET, volume);
     m_accessClk = 0;
     if (m_context != 0)
@@ -137,16 +133,13 @@ void HardSID::clock()
     if (!m_handle)
         return;
 
-    event_clock_t cycles = m_context->getTime(m_accessClk, EVENT_CLOCK_PHI1);
+    const event_clock_t cycles = m_context->getTime(m_accessClk, EVENT_CLOCK_PHI1);
     m_accessClk += cycles;
 
-    while (cycles > 0xffff)
-    {
-        ioctl(m_handle, HSID_IOCTL_DELAY, 0xffff);
-        cycles -= 0xffff;
-    }
-    if (cycles)
-        ioctl(m_handle, HSID_IOCTL_DELAY, cycles);
+    // A single write for each audio buffer
+    m_queue.delay(cycles);
+    m_queue.flush();
+    checkQueue();
 }
 
 uint8_t HardSID::read(uint_least8_t addr)
@@ -154,17 +147,15 @@ uint8_t HardSID::read(uint_least8_t addr)
     if (!m_handle)
         return 0;
 
-    event_clock_t cycles = m_context->getTime(m_accessClk, EVENT_CLOCK_PHI1);
+    const event_clock_t cycles = m_context->getTime(m_accessClk, EVENT_CLOCK_PHI1);
     m_accessClk += cycles;
 
-    while ( cycles > 0xffff )
-    {
-        /* delay */
-        ioctl(m_handle, HSID_IOCTL_DELAY, 0xffff);
-        cycles -= 0xffff;
-    }
+    // The read waits for the queued writes
+    m_queue.delay(cycles);
+    const unsigned int wait = m_queue.sync();
+    checkQueue();
 
-    unsigned int packet = (( cycles & 0xffff ) << 16 ) | (( addr & 0x1f ) << 8 );
+    unsigned int packet = (( wait & 0xffff ) << 16 ) | (( addr & 0x1f ) << 8 );
     ioctl(m_handle, HSID_IOCTL_READ, &packet);
 
     return static_cast<uint8_t>(packet & 0xff);
@@ -175,20 +166,11 @@ void HardSID::write(uint_least8_t addr, uint8_t data)
     if (!m_handle)
         return;
 
-    event_clock_t cycles = m_context->getTime(m_accessClk, EVENT_CLOCK_PHI1);
+    const event_clock_t cycles = m_context->getTime(m_accessClk, EVENT_CLOCK_PHI1);
     m_accessClk += cycles;
 
-    while (cycles > 0xffff)
-    {
-        /* delay */
-        ioctl(m_handle, HSID_IOCTL_DELAY, 0xffff);
-        cycles -= 0xffff;
-    }
-
-    unsigned int packet = (( cycles & 0xffff ) << 16 ) | (( addr & 0x1f ) << 8 )
-        | (data & 0xff);
-
-    ::write(m_handle, &packet, sizeof(packet));
+    m_queue.write(cycles, addr & 0x1f, data);
+    checkQueue();
 }
 
 void HardSID::voice(unsigned int num, bool mute)
@@ -201,6 +183,8 @@ void HardSID::voice(unsigned int num, bool mute)
     int cmute = 0;
     for ( unsigned int i = 0; i < voices; i++ )
         cmute |= (muted[i] << i);
+    m_queue.flush();
+    checkQueue();
     ioctl(m_handle, HSID_IOCTL_MUTE, cmute);
 }
 
@@ -215,21 +199,45 @@ void HardSID::event()
     else
     {
         m_accessClk += cycles;
-        ioctl(m_handle, HSID_IOCTL_DELAY, static_cast<uint>(cycles));
+        m_queue.delay(cycles);
+        m_queue.idle();
+        checkQueue();
         m_context->schedule(*this, HARDSID_DELAY_CYCLES, EVENT_CLOCK_PHI1);
     }
 }
 
 void HardSID::filter(bool enable)
 {
+    m_queue.flush();
+    checkQueue();
     ioctl(m_handle, HSID_IOCTL_NOFILTER, !enable);
 }
 
+void HardSID::latency(unsigned int cycles)
+{
+    m_queue.latency(cycles);
+}
+
 void HardSID::flush()
 {
+    // The queued packets go away with the device FIFO
+    m_queue.clear();
     ioctl(m_handle, HSID_IOCTL_FLUSH);
 }
 
+/**
+ * Report the failed transfers of the queue,
+ * including the ones of its own flushes.
+ */
+void HardSID::checkQueue()
+{
+    if (m_queue.failed() && m_status)
+    {
+        m_status = false;
+        m_error = "HARDSID ERROR: Write to the device failed";
+    }
+}
+
 bool HardSID::lock(EventContext* env)
 {
     sidemu::lock(env);
@@ -240,6 +248,8 @@ bool HardSID::lock(EventContext* env)
 
 void HardSID::unlock()
 {
+    m_queue.flush();
+    checkQueue();
     m_context->cancel(*this);
     sidemu::unlock();
 }
@@ -187,3 +187,6 @@ void HardSID::flush()
 {
     hsid2.Flush((BYTE) m_instance);
 }
+
+// The DLL does its own buffering
+void HardSID::latency(unsigned int) {}
@@ -87,6 +87,10 @@ struct HsidDLL2
     WORD               Version;
 };
 
+#else
+
+#include "hardsid-queue.h"
+
 #endif // _WIN32
 
 #define HARDSID_VOICES 3
@@ -105,6 +109,7 @@ private:
 #ifndef _WIN32
     static         bool m_sidFree[16];
     int            m_handle;
+    HardSIDQueue   m_queue;
 #endif
 
     static const unsigned int voices;
@@ -142,6 +147,7 @@ public:
     // HardSID specific
     void flush();
     void filter(bool enable);
+    void latency(unsigned int cycles);
 
     // Must lock the SID before using the standard functions.
     bool lock(EventContext *env) override;
@@ -152,6 +158,10 @@ private:
     // shoot to 100% CPU usage when song nolonger
     // writes to SID.
     void event() override;
+
+#ifndef _WIN32
+    void checkQueue();
+#endif
 };
 
 #endif // HARDSID_EMU_H
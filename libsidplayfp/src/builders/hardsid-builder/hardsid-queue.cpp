@@ -0,0 +1,131 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2015 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "hardsid-queue.h"
+
+#include <unistd.h>
+#include <errno.h>
+
+/// Highest number of cycles in a packet
+const unsigned int MAX_CYCLES = 0xffff;
+
+/// Queued packets forcing a flush
+const size_t MAX_PACKETS = 4096;
+
+void HardSIDQueue::push(unsigned int cycles, unsigned int reg, unsigned int data)
+{
+    m_packets.push_back((cycles << 16) | ((reg & 0xff) << 8) | (data & 0xff));
+    m_queued += cycles;
+
+    if (m_queued >= m_latency || m_packets.size() >= MAX_PACKETS)
+        flush();
+}
+
+void HardSIDQueue::delay(event_clock_t cycles)
+{
+    m_pending += cycles;
+
+    while (m_pending > MAX_CYCLES)
+    {
+        wait(MAX_CYCLES);
+        m_pending -= MAX_CYCLES;
+    }
+}
+
+void HardSIDQueue::idle()
+{
+    if (m_pending == 0)
+        return;
+
+    const unsigned int cycles = static_cast<unsigned int>(m_pending);
+    m_pending = 0;
+    wait(cycles);
+}
+
+void HardSIDQueue::wait(unsigned int cycles)
+{
+    if (!flush())
+        return;
+
+    if (m_handle >= 0 && ioctl(m_handle, HSID_IOCTL_DELAY, cycles) < 0)
+        m_failed = true;
+}
+
+void HardSIDQueue::write(event_clock_t cycles, unsigned int reg, unsigned int data)
+{
+    delay(cycles);
+
+    const unsigned int wait = static_cast<unsigned int>(m_pending);
+    m_pending = 0;
+    push(wait, reg, data);
+}
+
+unsigned int HardSIDQueue::sync()
+{
+    flush();
+
+    const unsigned int wait = static_cast<unsigned int>(m_pending);
+    m_pending = 0;
+    return wait;
+}
+
+bool HardSIDQueue::flush()
+{
+    if (m_packets.empty())
+        return true;
+
+    bool ok = m_handle >= 0;
+    if (ok)
+    {
+        m_flushes++;
+
+        const char *data = reinterpret_cast<const char*>(&m_packets[0]);
+        size_t size = m_packets.size() * sizeof(unsigned int);
+
+        // The device blocks while its FIFO is full
+        while (size > 0)
+        {
+            const ssize_t n = ::write(m_handle, data, size);
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                ok = false;
+                break;
+            }
+            data += n;
+            size -= n;
+        }
+    }
+
+    if (!ok)
+        m_failed = true;
+
+    m_packets.clear();
+    m_queued = 0;
+    return ok;
+}
+
+void HardSIDQueue::clear()
+{
+    m_packets.clear();
+    m_pending = 0;
+    m_queued = 0;
+}
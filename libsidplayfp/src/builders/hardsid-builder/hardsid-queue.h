@@ -0,0 +1,163 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2015 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef HARDSID_QUEUE_H
+#define HARDSID_QUEUE_H
+
+#include <sys/ioctl.h>
+
+#include <vector>
+
+#include "sidplayfp/event.h"
+
+// HardSID character device interface
+#define HSID_IOCTL_RESET     _IOW('S', 0, int)
+#define HSID_IOCTL_FIFOSIZE  _IOR('S', 1, int)
+#define HSID_IOCTL_FIFOFREE  _IOR('S', 2, int)
+#define HSID_IOCTL_SIDTYPE   _IOR('S', 3, int)
+#define HSID_IOCTL_CARDTYPE  _IOR('S', 4, int)
+#define HSID_IOCTL_MUTE      _IOW('S', 5, int)
+#define HSID_IOCTL_NOFILTER  _IOW('S', 6, int)
+#define HSID_IOCTL_FLUSH     _IO ('S', 7)
+#define HSID_IOCTL_DELAY     _IOW('S', 8, int)
+#define HSID_IOCTL_READ      _IOWR('S', 9, int*)
+
+/// Default latency bound, approx 20ms
+#define HARDSID_LATENCY_CYCLES 20000
+
+/**
+ * User space queue of the packets for the HardSID device.
+ *
+ * The packets hold the cycles to wait before the write in bits 16-31,
+ * the register in bits 8-15 and the value in bits 0-7.
+ * Every packet is a bus write, even to an unused register,
+ * so the waits which don't fit in a packet, or which have no write
+ * after them, go through the delay ioctl after sending the queue.
+ *
+ * The packets are sent with a single write per flush,
+ * the owner flushes once per audio buffer and the queue
+ * flushes itself when the queued cycles reach the latency bound.
+ */
+class HardSIDQueue
+{
+private:
+    /// The device, -1 if none
+    int m_handle;
+
+    /// Packets not sent yet
+    std::vector<unsigned int> m_packets;
+
+    /// Cycles elapsed since the last packet
+    event_clock_t m_pending;
+
+    /// Cycles of the queued packets
+    event_clock_t m_queued;
+
+    /// Queued cycles forcing a flush
+    event_clock_t m_latency;
+
+    /// Write calls made
+    unsigned long m_flushes;
+
+    /// A transfer to the device has failed
+    bool m_failed;
+
+private:
+    void push(unsigned int cycles, unsigned int reg, unsigned int data);
+
+protected:
+    /**
+     * Send the queued packets, then make the device wait.
+     *
+     * @param cycles the cycles to wait, at most 0xffff
+     */
+    virtual void wait(unsigned int cycles);
+
+    int handle() const { return m_handle; }
+
+    void fail() { m_failed = true; }
+
+public:
+    HardSIDQueue() :
+        m_handle(-1),
+        m_pending(0),
+        m_queued(0),
+        m_latency(HARDSID_LATENCY_CYCLES),
+        m_flushes(0),
+        m_failed(false) {}
+
+    virtual ~HardSIDQueue() {}
+
+    void setHandle(int handle) { m_handle = handle; m_failed = false; }
+
+    /**
+     * Set the latency bound.
+     *
+     * @param cycles the queued cycles forcing a flush, 0 to send each packet right away
+     */
+    void latency(unsigned int cycles) { m_latency = cycles; }
+
+    /**
+     * Let cycles elapse.
+     */
+    void delay(event_clock_t cycles);
+
+    /**
+     * Make the device wait for the cycles elapsed.
+     */
+    void idle();
+
+    /**
+     * Queue a write after the cycles elapsed.
+     */
+    void write(event_clock_t cycles, unsigned int reg, unsigned int data);
+
+    /**
+     * Send the queued packets, keeping the cycles elapsed since the last one.
+     *
+     * @return the cycles elapsed since the last packet, at most 0xffff
+     */
+    unsigned int sync();
+
+    /**
+     * Send the queued packets.
+     *
+     * @return false on write errors
+     */
+    bool flush();
+
+    /**
+     * Drop the queued packets and the elapsed cycles.
+     */
+    void clear();
+
+    /**
+     * Number of write calls made.
+     */
+    unsigned long flushes() const { return m_flushes; }
+
+    /**
+     * Check if a transfer to the device has failed,
+     * including the flushes done by the queue itself.
+     */
+    bool failed() const { return m_failed; }
+};
+
+#endif // HARDSID_QUEUE_H
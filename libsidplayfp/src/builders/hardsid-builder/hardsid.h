@@ -60,6 +60,15 @@ public:
      */
     void filter(bool enable);
 
+    /**
+     * Set the latency bound of the write queue.
+     * The writes are sent to the device once per audio buffer
+     * or when the queued cycles reach the bound (default 20000).
+     *
+     * @param cycles the bound in cycles, 0 to send each write right away
+     */
+    void latency(unsigned int cycles);
+
     /**
      * Create the sid emu.
      *
@@ -0,0 +1,74 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2015 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "remote.h"
+
+#include <algorithm>
+#include <memory>
+#include <new>
+
+#include "remote-emu.h"
+
+RemoteBuilder::~RemoteBuilder()
+{   // Remove all SID emulations
+    remove();
+}
+
+// Create a new sid emulation.
+unsigned int RemoteBuilder::create(unsigned int sids)
+{
+    m_status = true;
+
+    unsigned int count;
+    for (count = 0; count < sids; count++)
+    {
+        try
+        {
+            std::unique_ptr<RemoteSID> sid(new RemoteSID(this, m_path.c_str()));
+
+            // Connection failed?
+            if (!sid->getStatus())
+            {
+                m_errorBuffer = sid->error();
+                m_status = false;
+                break;
+            }
+            sidobjs.insert(sid.release());
+        }
+        // Memory alloc failed?
+        catch (std::bad_alloc const &)
+        {
+            m_errorBuffer.assign(name()).append(" ERROR: Unable to create RemoteSID object");
+            m_status = false;
+            break;
+        }
+    }
+    return count;
+}
+
+const char *RemoteBuilder::credits() const
+{
+    return RemoteSID::getCredits();
+}
+
+void RemoteBuilder::filter(bool enable)
+{
+    std::for_each(sidobjs.begin(), sidobjs.end(), applyParameter<RemoteSID, bool>(&RemoteSID::filter, enable));
+}
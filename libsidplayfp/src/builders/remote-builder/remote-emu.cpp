@@ -0,0 +1,318 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2015 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "remote-emu.h"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <algorithm>
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+/// Packets queued before sending them without waiting for a reply
+const size_t BATCH_PACKETS = 4096;
+
+const char ERR_CONNECTION_LOST[] = "REMOTE ERROR: Connection to the server lost";
+
+const char* RemoteSID::getCredits()
+{
+    if (m_credit.empty())
+    {
+        // Setup credits
+        std::ostringstream ss;
+        ss << "Remote SID V" << VERSION << " Engine:\n";
+        ss << "\tRendering by an external server\n";
+        m_credit = ss.str();
+    }
+
+    return m_credit.c_str();
+}
+
+RemoteSID::RemoteSID(sidbuilder *builder, const char *path) :
+    sidemu(builder),
+    m_socket(-1),
+    m_cyclesPerSample(0.),
+    m_silentCycles(0.)
+{
+    m_buffer = new short[OUTPUTBUFFERSIZE * 2];
+
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+
+    if (strlen(path) < sizeof(address.sun_path))
+    {
+        strcpy(address.sun_path, path);
+
+        m_socket = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (m_socket >= 0 && connect(m_socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0)
+        {
+            close(m_socket);
+            m_socket = -1;
+        }
+    }
+
+    if (m_socket < 0)
+    {
+        m_error.assign("REMOTE ERROR: Cannot connect to \"").append(path).append("\"");
+        m_status = false;
+        return;
+    }
+
+    reset(0);
+}
+
+RemoteSID::~RemoteSID()
+{
+    if (m_socket >= 0)
+        close(m_socket);
+    delete[] m_buffer;
+}
+
+void RemoteSID::disconnect()
+{
+    close(m_socket);
+    m_socket = -1;
+    m_packets.clear();
+    m_silentCycles = 0.;
+    m_error = ERR_CONNECTION_LOST;
+}
+
+bool RemoteSID::send()
+{
+    if (m_socket < 0)
+        return false;
+
+    const char *data = reinterpret_cast<const char*>(&m_packets[0]);
+    size_t size = m_packets.size() * sizeof(uint32_t);
+    while (size > 0)
+    {
+        const ssize_t n = ::send(m_socket, data, size, MSG_NOSIGNAL);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            disconnect();
+            return false;
+        }
+        data += n;
+        size -= n;
+    }
+
+    m_packets.clear();
+    return true;
+}
+
+bool RemoteSID::receive(void *data, size_t size)
+{
+    if (m_socket < 0)
+        return false;
+
+    char *p = static_cast<char*>(data);
+    while (size > 0)
+    {
+        const ssize_t n = recv(m_socket, p, size, 0);
+        if (n <= 0)
+        {
+            if (n < 0 && errno == EINTR)
+                continue;
+            disconnect();
+            return false;
+        }
+        p += n;
+        size -= n;
+    }
+
+    return true;
+}
+
+void RemoteSID::command(uint8_t command, uint8_t value)
+{
+    event_clock_t cycles = m_context->getTime(m_accessClk, EVENT_CLOCK_PHI1);
+    m_accessClk += cycles;
+
+    if (m_socket < 0)
+    {
+        m_silentCycles += cycles;
+        return;
+    }
+
+    while (cycles > REMOTE_MAX_CYCLES)
+    {
+        m_packets.push_back(remotePacket(REMOTE_MAX_CYCLES, REMOTE_DELAY, 0));
+        cycles -= REMOTE_MAX_CYCLES;
+    }
+
+    m_packets.push_back(remotePacket(cycles, command, value));
+}
+
+void RemoteSID::queue(uint8_t command, uint8_t value)
+{
+    if (m_socket >= 0)
+        m_packets.push_back(remotePacket(0, command, value));
+}
+
+void RemoteSID::reset(uint8_t volume)
+{
+    m_accessClk = 0;
+    queue(REMOTE_RESET, volume);
+}
+
+uint8_t RemoteSID::read(uint_least8_t addr)
+{
+    command(REMOTE_READ, addr & 0x1f);
+
+    // The only round trip besides the audio
+    uint32_t value;
+    if (!send() || !receive(&value, sizeof(value)))
+        return 0;
+
+    return static_cast<uint8_t>(value);
+}
+
+void RemoteSID::write(uint_least8_t addr, uint8_t data)
+{
+    command(addr & 0x1f, data);
+
+    if (m_packets.size() >= BATCH_PACKETS)
+        send();
+}
+
+void RemoteSID::clock()
+{
+    command(REMOTE_CLOCK, 0);
+
+    uint32_t count;
+    if (send() && receive(&count, sizeof(count)))
+    {
+        // The mixer never lets the ring get more than half full
+        if (count > OUTPUTBUFFERSIZE)
+        {
+            disconnect();
+        }
+        else if (receive(m_buffer + m_bufferpos, count * sizeof(short)))
+        {
+            m_bufferpos += count;
+            wrapBuffer();
+            return;
+        }
+    }
+
+    // Without a server play silence, the mixer waits for the samples
+    if (m_cyclesPerSample > 0.)
+    {
+        const int samples = static_cast<int>(m_silentCycles / m_cyclesPerSample);
+        m_silentCycles -= samples * m_cyclesPerSample;
+        std::fill(m_buffer + m_bufferpos, m_buffer + m_bufferpos + samples, 0);
+        m_bufferpos += samples;
+        wrapBuffer();
+    }
+}
+
+void RemoteSID::sampling(float systemclock, float freq,
+        SidConfig::sampling_method_t method, bool)
+{
+    uint8_t value;
+    switch (method)
+    {
+    case SidConfig::INTERPOLATE:
+        value = 0;
+        break;
+    case SidConfig::RESAMPLE_INTERPOLATE:
+        value = 1;
+        break;
+    default:
+        m_status = false;
+        m_error = ERR_INVALID_SAMPLING;
+        return;
+    }
+
+    m_cyclesPerSample = systemclock / freq;
+
+    uint32_t clockBits;
+    uint32_t freqBits;
+    memcpy(&clockBits, &systemclock, sizeof(clockBits));
+    memcpy(&freqBits, &freq, sizeof(freqBits));
+
+    queue(REMOTE_SAMPLING, value);
+    if (m_socket >= 0)
+    {
+        m_packets.push_back(clockBits);
+        m_packets.push_back(freqBits);
+    }
+
+    uint32_t result;
+    if (!send() || !receive(&result, sizeof(result)))
+    {
+        m_status = false;
+        m_error = ERR_CONNECTION_LOST;
+        return;
+    }
+
+    if (result != 0)
+    {
+        m_status = false;
+        m_error = ERR_UNSUPPORTED_FREQ;
+        return;
+    }
+
+    m_status = true;
+}
+
+void RemoteSID::model(SidConfig::sid_model_t model)
+{
+    switch (model)
+    {
+        case SidConfig::MOS6581:
+            queue(REMOTE_MODEL, 0);
+            break;
+        case SidConfig::MOS8580:
+            queue(REMOTE_MODEL, 1);
+            break;
+        default:
+            m_status = false;
+            m_error = ERR_INVALID_CHIP;
+            return;
+    }
+
+    m_status = true;
+}
+
+void RemoteSID::voice(unsigned int num, bool mute)
+{
+    // Only have 3 voices!
+    if (num >= 3)
+        return;
+
+    queue(REMOTE_VOICE, num | (mute ? 0x80 : 0));
+}
+
+void RemoteSID::filter(bool enable)
+{
+    queue(REMOTE_FILTER, enable ? 1 : 0);
+}
@@ -0,0 +1,123 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2015 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef REMOTE_EMU_H
+#define REMOTE_EMU_H
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "sidemu.h"
+#include "sidplayfp/event.h"
+#include "sidplayfp/siddefs.h"
+
+#include "remote-protocol.h"
+
+#include "sidcxx11.h"
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+class sidbuilder;
+
+/***************************************************************************
+ * Remote SID Specialisation
+ ***************************************************************************/
+class RemoteSID : public sidemu
+{
+private:
+    /// Socket connected to the server, -1 if broken
+    int m_socket;
+
+    /// Packets not sent yet
+    std::vector<uint32_t> m_packets;
+
+    /// Cycles per sample, for the silence produced without a server
+    double m_cyclesPerSample;
+
+    /// Cycles not turned into silence yet
+    double m_silentCycles;
+
+public:
+    static const char* getCredits();
+
+public:
+    RemoteSID(sidbuilder *builder, const char *path);
+    ~RemoteSID();
+
+    bool getStatus() const { return m_status; }
+
+    // Standard component functions
+    void reset() override { sidemu::reset(); }
+
+    uint8_t read(uint_least8_t addr) override;
+    void write(uint_least8_t addr, uint8_t data) override;
+
+    // c64sid functions
+    void reset(uint8_t volume) override;
+
+    // Standard SID functions
+    void clock() override;
+
+    void sampling(float systemclock, float freq,
+        SidConfig::sampling_method_t method, bool) override;
+
+    void voice(unsigned int num, bool mute) override;
+
+    void model(SidConfig::sid_model_t model) override;
+
+    // Remote specific
+    void filter(bool enable);
+
+private:
+    /**
+     * Queue a command after the cycles elapsed since the last access.
+     */
+    void command(uint8_t command, uint8_t value);
+
+    /**
+     * Queue a command without running the cycles elapsed,
+     * for the settings which take effect right away.
+     */
+    void queue(uint8_t command, uint8_t value);
+
+    /**
+     * Send the queued packets.
+     *
+     * @return false if the connection is broken
+     */
+    bool send();
+
+    /**
+     * Receive a reply.
+     *
+     * @return false if the connection is broken
+     */
+    bool receive(void *data, size_t size);
+
+    /**
+     * The server is gone, keep on playing silence.
+     */
+    void disconnect();
+};
+
+#endif // REMOTE_EMU_H
@@ -0,0 +1,77 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2015 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef REMOTE_PROTOCOL_H
+#define REMOTE_PROTOCOL_H
+
+#include <stdint.h>
+
+/*
+ * Protocol between the remote builder and a SID server
+ * over a Unix domain stream socket, one connection per chip.
+ *
+ * The client sends 32 bit packets in native byte order,
+ * as both ends run on the same machine.
+ * Like the HardSID packets they hold the cycles to run
+ * before the command in bits 16-31, the command in bits 8-15
+ * and its value in bits 0-7.
+ * Commands 0x00-0x1f write the register with the same number.
+ *
+ * Packets are queued by the client and sent in batches,
+ * only the commands marked below wait for a reply,
+ * which is a 32 bit word possibly followed by data.
+ */
+
+/// Only run the cycles
+const uint8_t REMOTE_DELAY = 0x20;
+
+/// Send back the samples produced since the last request,
+/// replies with the number of samples followed by them as 16 bit values
+const uint8_t REMOTE_CLOCK = 0x21;
+
+/// Read the register in the value, replies with the value read
+const uint8_t REMOTE_READ = 0x22;
+
+/// Reset the chip, then write the value to the volume register
+const uint8_t REMOTE_RESET = 0x23;
+
+/// Set the model, 0 for MOS6581 and 1 for MOS8580
+const uint8_t REMOTE_MODEL = 0x24;
+
+/// Set the sampling method in the value, 0 for decimation and 1 for resampling,
+/// followed by the clock and the sampling frequencies as 32 bit floats,
+/// replies with 0 on success
+const uint8_t REMOTE_SAMPLING = 0x25;
+
+/// Mute the voice in bits 0-1 of the value if bit 7 is set, unmute it otherwise
+const uint8_t REMOTE_VOICE = 0x26;
+
+/// Enable the filter if the value is not 0
+const uint8_t REMOTE_FILTER = 0x27;
+
+/// Highest number of cycles in a packet
+const unsigned int REMOTE_MAX_CYCLES = 0xffff;
+
+inline uint32_t remotePacket(unsigned int cycles, uint8_t command, uint8_t value)
+{
+    return (static_cast<uint32_t>(cycles) << 16) | (static_cast<uint32_t>(command) << 8) | value;
+}
+
+#endif // REMOTE_PROTOCOL_H
@@ -0,0 +1,74 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2015 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef REMOTE_H
+#define REMOTE_H
+
+#include <string>
+
+#include "sidplayfp/sidbuilder.h"
+#include "sidplayfp/siddefs.h"
+
+/**
+ * Remote Builder Class
+ *
+ * The chips are rendered by a separate server process,
+ * connected through a Unix domain socket,
+ * which sends the audio back in blocks.
+ */
+class SID_EXTERN RemoteBuilder : public sidbuilder
+{
+private:
+    const std::string m_path;
+
+public:
+    /**
+     * @param name the builder's name
+     * @param path the path of the server socket
+     */
+    RemoteBuilder(const char * const name, const char *path) :
+        sidbuilder(name),
+        m_path(path) {}
+    ~RemoteBuilder();
+
+    /**
+     * Available sids.
+     *
+     * @return the number of available sids, 0 = endless.
+     */
+    unsigned int availDevices() const { return 0; }
+
+    /**
+     * Create the sid emu.
+     * Each chip opens its own connection to the server.
+     *
+     * @param sids the number of required sid emu
+     */
+    unsigned int create(unsigned int sids);
+
+    const char *credits() const;
+
+    /**
+     * enable/disable filter.
+     */
+    void filter(bool enable);
+};
+
+#endif // REMOTE_H
@@ -51,7 +51,7 @@ ReSID::ReSID(sidbuilder *builder) :
     m_sid(*(new RESID_NS::SID)),
     m_voiceMask(0x07)
 {
-    m_buffer = new short[OUTPUTBUFFERSIZE];
+    m_buffer = new short[OUTPUTBUFFERSIZE * 2];
     reset(0);
 }
 
@@ -90,7 +90,8 @@ void ReSID::clock()
 {
     RESID_NS::cycle_count cycles = m_context->getTime(m_accessClk, EVENT_CLOCK_PHI1);
     m_accessClk += cycles;
-    m_bufferpos += m_sid.clock(cycles, (short *) m_buffer + m_bufferpos, OUTPUTBUFFERSIZE - m_bufferpos, 1);
+    m_bufferpos += m_sid.clock(cycles, (short *) m_buffer + m_bufferpos, OUTPUTBUFFERSIZE * 2 - m_bufferpos, 1);
+    wrapBuffer();
 }
 
 void ReSID::filter(bool enable)
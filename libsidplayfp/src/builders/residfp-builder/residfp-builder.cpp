@@ -26,6 +26,7 @@
 #include <new>
 
 #include "residfp-emu.h"
+#include "residfp/VoiceKernel.h"
 
 ReSIDfpBuilder::~ReSIDfpBuilder()
 {   // Remove all SID emulations
@@ -80,3 +81,13 @@ void ReSIDfpBuilder::filter8580Curve(double filterCurve)
 {
     std::for_each(sidobjs.begin(), sidobjs.end(), applyParameter<ReSIDfp, double>(&ReSIDfp::filter8580Curve, filterCurve));
 }
+
+void ReSIDfpBuilder::simd(bool enable)
+{
+    std::for_each(sidobjs.begin(), sidobjs.end(), applyParameter<ReSIDfp, bool>(&ReSIDfp::simd, enable));
+}
+
+bool ReSIDfpBuilder::simdVectorized()
+{
+    return reSIDfp::VoiceKernel::vectorized();
+}
@@ -54,7 +54,7 @@ ReSIDfp::ReSIDfp(sidbuilder *builder) :
     sidemu(builder),
     m_sid(*(new RESID_NAMESPACE::SID))
 {
-    m_buffer = new short[OUTPUTBUFFERSIZE];
+    m_buffer = new short[OUTPUTBUFFERSIZE * 2];
     reset(0);
 }
 
@@ -99,6 +99,7 @@ void ReSIDfp::clock()
     const event_clock_t cycles = m_context->getTime(m_accessClk, EVENT_CLOCK_PHI1);
     m_accessClk += cycles;
     m_bufferpos += m_sid.clock(cycles, m_buffer+m_bufferpos);
+    wrapBuffer();
 }
 
 void ReSIDfp::filter(bool enable)
@@ -106,6 +107,11 @@ void ReSIDfp::filter(bool enable)
       m_sid.enableFilter(enable);
 }
 
+void ReSIDfp::simd(bool enable)
+{
+      m_sid.enableSimd(enable);
+}
+
 void ReSIDfp::sampling(float systemclock, float freq,
         SidConfig::sampling_method_t method, bool)
 {
@@ -73,6 +73,7 @@ public:
     void filter(bool enable);
     void filter6581Curve(double filterCurve);
     void filter8580Curve(double filterCurve);
+    void simd(bool enable);
 };
 
 #endif // RESIDFP_EMU_H
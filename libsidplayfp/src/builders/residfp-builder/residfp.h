@@ -73,6 +73,20 @@ public:
      * @param filterCurve curve center frequency (default 12500)
      */
     void filter8580Curve(double filterCurve);
+
+    /**
+     * Clock the three voices of each SID together with
+     * vector instructions. The output doesn't change.
+     *
+     * @param enable true to use the vector code
+     */
+    void simd(bool enable);
+
+    /**
+     * Tell whether simd() uses SSE2 in this build
+     * or falls back to a plain loop.
+     */
+    static bool simdVectorized();
     //@}
 };
 
@@ -41,6 +41,8 @@ namespace reSIDfp
  */
 class EnvelopeGenerator
 {
+    friend class VoiceKernel;
+
 private:
     /**
      * The envelope state machine's distinct states. In addition to this,
@@ -56,7 +56,9 @@ SID::SID() :
     externalFilter(new ExternalFilter()),
     resampler(0),
     potX(new Potentiometer()),
-    potY(new Potentiometer())
+    potY(new Potentiometer()),
+    samplingMethod(DECIMATE),
+    outputStage(0)
 {
     voice[0].reset(new Voice());
     voice[1].reset(new Voice());
@@ -89,6 +91,11 @@ void SID::enableFilter(bool enable)
     filter8580->enable(enable);
 }
 
+void SID::enableSimd(bool enable)
+{
+    voiceKernel.reset(enable ? new VoiceKernel(voice[0].get(), voice[1].get(), voice[2].get()) : 0);
+}
+
 void SID::writeImmediate(int offset, unsigned char value)
 {
     switch (offset)
@@ -258,6 +265,8 @@ void SID::setChipModel(ChipModel model)
 
     this->model = model;
 
+    setOutputStage();
+
     /* calculate waveform-related tables, feed them to the generator */
     matrix_t* tables = WaveformCalculator::getInstance()->buildTable(model);
 
@@ -364,6 +373,54 @@ void SID::setSamplingParameters(double clockFrequency, SamplingMethod method, do
     default:
         throw SIDError("Unknown sampling method\n");
     }
+
+    samplingMethod = method;
+    setOutputStage();
+}
+
+template<class FilterType, class ResamplerType>
+int SID::clockOutput(unsigned int n, short* buf)
+{
+    FilterType* const f = static_cast<FilterType*>(filter);
+    ResamplerType* const r = static_cast<ResamplerType*>(resampler.get());
+
+    for (unsigned int i = 0; i < n; i++)
+    {
+        blockOutput[i] = f->FilterType::clock(voiceOutput[0][i], voiceOutput[1][i], voiceOutput[2][i]);
+    }
+
+    for (unsigned int i = 0; i < n; i++)
+    {
+        blockOutput[i] = externalFilter->clock(blockOutput[i]);
+    }
+
+    int s = 0;
+
+    for (unsigned int i = 0; i < n; i++)
+    {
+        if (unlikely(r->ResamplerType::input(blockOutput[i])))
+        {
+            buf[s++] = Resampler::clip(r->ResamplerType::output());
+        }
+    }
+
+    return s;
+}
+
+void SID::setOutputStage()
+{
+    if (model == MOS6581)
+    {
+        outputStage = samplingMethod == DECIMATE
+            ? &SID::clockOutput<Filter6581, ZeroOrderResampler>
+            : &SID::clockOutput<Filter6581, TwoPassSincResampler>;
+    }
+    else
+    {
+        outputStage = samplingMethod == DECIMATE
+            ? &SID::clockOutput<Filter8580, ZeroOrderResampler>
+            : &SID::clockOutput<Filter8580, TwoPassSincResampler>;
+    }
 }
 
 void SID::clockSilent(unsigned int cycles)
@@ -36,6 +36,7 @@ class Filter8580;
 class ExternalFilter;
 class Potentiometer;
 class Voice;
+class VoiceKernel;
 class Resampler;
 
 /**
@@ -57,6 +58,13 @@ public:
  */
 class SID
 {
+private:
+    /// Number of cycles processed by each stage of #clock at a time
+    enum { BLOCK_SIZE = 256 };
+
+    /// Output stage specialized for the filter and resampler in use
+    typedef int (SID::*OutputStage)(unsigned int n, short* buf);
+
 private:
     /// Currently active filter
     Filter* filter;
@@ -85,6 +93,9 @@ private:
     /// SID voices
     std::auto_ptr<Voice> voice[3];
 
+    /// Vectorized clocking of the voices, null if disabled
+    std::auto_ptr<VoiceKernel> voiceKernel;
+
     /// Time to live for the last written value
     int busValueTtl;
 
@@ -100,6 +111,12 @@ private:
     /// Currently active chip model.
     ChipModel model;
 
+    /// Currently active sampling method.
+    SamplingMethod samplingMethod;
+
+    /// Output stage for the current chip model and sampling method
+    OutputStage outputStage;
+
     /// Delayed MOS8580 write value
     unsigned char delayedValue;
 
@@ -109,6 +126,12 @@ private:
     /// Flags for muted channels
     bool muted[3];
 
+    /// Voice outputs of the block being clocked
+    int voiceOutput[3][BLOCK_SIZE];
+
+    /// Filter and external filter outputs of the block being clocked
+    int blockOutput[BLOCK_SIZE];
+
 private:
     /**
      * Write value to register during this clock cycle.
@@ -126,11 +149,31 @@ private:
     void ageBusValue(unsigned int n);
 
     /**
-     * Get output sample.
+     * Clock the waveform and envelope generators
+     * and store the voice outputs of each cycle.
      *
-     * @return the output sample
+     * @param n the number of cycles, at most BLOCK_SIZE
      */
-    int output() const;
+    void clockVoices(unsigned int n);
+
+    /**
+     * Run a block of cycles through the filter,
+     * the external filter and the resampler.
+     * Instantiated for each filter and resampler type
+     * so that their clocking can be inlined.
+     *
+     * @param n the number of cycles, at most BLOCK_SIZE
+     * @param buf audio output buffer
+     * @return number of samples produced
+     */
+    template<class FilterType, class ResamplerType>
+    int clockOutput(unsigned int n, short* buf);
+
+    /**
+     * Select the output stage for the current
+     * chip model and sampling method.
+     */
+    void setOutputStage();
 
     /**
      * Calculate the numebr of cycles according to current parameters
@@ -276,6 +319,14 @@ public:
      * @param enable false to turn off filter emulation
      */
     void enableFilter(bool enable);
+
+    /**
+     * Clock the three voices together with vector instructions.
+     * The output is the same as with the scalar code.
+     *
+     * @param enable false to clock each voice on its own
+     */
+    void enableSimd(bool enable);
 };
 
 } // namespace reSIDfp
@@ -287,6 +338,7 @@ public:
 #include "Filter.h"
 #include "ExternalFilter.h"
 #include "Voice.h"
+#include "VoiceKernel.h"
 #include "resample/Resampler.h"
 
 namespace reSIDfp
@@ -308,15 +360,35 @@ void SID::ageBusValue(unsigned int n)
 }
 
 RESID_INLINE
-int SID::output() const
+void SID::clockVoices(unsigned int n)
 {
-    const int v1 = voice[0]->output(voice[2]->wave());
-    const int v2 = voice[1]->output(voice[0]->wave());
-    const int v3 = voice[2]->output(voice[1]->wave());
+    if (voiceKernel.get() != 0)
+    {
+        int* const output[3] = { voiceOutput[0], voiceOutput[1], voiceOutput[2] };
 
-    return externalFilter->clock(filter->clock(v1, v2, v3));
-}
+        if (likely(voiceKernel->clock(n, output)))
+        {
+            return;
+        }
+    }
 
+    for (unsigned int i = 0; i < n; i++)
+    {
+        /* clock waveform generators */
+        voice[0]->wave()->clock();
+        voice[1]->wave()->clock();
+        voice[2]->wave()->clock();
+
+        /* clock envelope generators */
+        voice[0]->envelope()->clock();
+        voice[1]->envelope()->clock();
+        voice[2]->envelope()->clock();
+
+        voiceOutput[0][i] = voice[0]->output(voice[2]->wave());
+        voiceOutput[1][i] = voice[1]->output(voice[0]->wave());
+        voiceOutput[2][i] = voice[2]->output(voice[1]->wave());
+    }
+}
 
 RESID_INLINE
 int SID::clock(unsigned int cycles, short* buf)
@@ -335,22 +407,16 @@ int SID::clock(unsigned int cycles, short* buf)
                 delta_t = 1;
             }
 
-            for (unsigned int i = 0; i < delta_t; i++)
+            // Each stage runs over a whole block before the next one,
+            // voice sync and delayed writes only end the block early
+            for (unsigned int i = 0; i < delta_t; )
             {
-                /* clock waveform generators */
-                voice[0]->wave()->clock();
-                voice[1]->wave()->clock();
-                voice[2]->wave()->clock();
-
-                /* clock envelope generators */
-                voice[0]->envelope()->clock();
-                voice[1]->envelope()->clock();
-                voice[2]->envelope()->clock();
-
-                if (unlikely(resampler->input(output())))
-                {
-                    buf[s++] = resampler->getOutput();
-                }
+                const unsigned int n = std::min(delta_t - i, static_cast<unsigned int>(BLOCK_SIZE));
+
+                clockVoices(n);
+                s += (this->*outputStage)(n, buf + s);
+
+                i += n;
             }
 
             if (unlikely(delayedOffset != -1))
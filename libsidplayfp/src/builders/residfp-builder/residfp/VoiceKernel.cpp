@@ -0,0 +1,274 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2015 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "VoiceKernel.h"
+
+#include "Voice.h"
+#include "WaveformGenerator.h"
+#include "EnvelopeGenerator.h"
+
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+
+namespace reSIDfp
+{
+
+namespace
+{
+
+#ifdef __SSE2__
+
+typedef __m128i lanes_t;
+
+inline lanes_t load(const unsigned int* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+inline void store(unsigned int* p, lanes_t a) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), a); }
+inline lanes_t splat(unsigned int v) { return _mm_set1_epi32(static_cast<int>(v)); }
+inline lanes_t add(lanes_t a, lanes_t b) { return _mm_add_epi32(a, b); }
+inline lanes_t band(lanes_t a, lanes_t b) { return _mm_and_si128(a, b); }
+inline lanes_t bor(lanes_t a, lanes_t b) { return _mm_or_si128(a, b); }
+inline lanes_t bxor(lanes_t a, lanes_t b) { return _mm_xor_si128(a, b); }
+/// ~a & b
+inline lanes_t bandnot(lanes_t a, lanes_t b) { return _mm_andnot_si128(a, b); }
+inline lanes_t srl(lanes_t a, int n) { return _mm_srli_epi32(a, n); }
+inline lanes_t sll(lanes_t a, int n) { return _mm_slli_epi32(a, n); }
+/// All ones in the lanes where a > b, both below 2^31
+inline lanes_t greater(lanes_t a, lanes_t b) { return _mm_cmpgt_epi32(a, b); }
+/// Bit mask of the lanes where a == b
+inline int equal(lanes_t a, lanes_t b) { return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, b))); }
+/// The accumulator ring modulating each voice: voice 3 for voice 1 and so on
+inline lanes_t ringSource(lanes_t a) { return _mm_shuffle_epi32(a, _MM_SHUFFLE(3, 1, 0, 2)); }
+
+#else
+
+struct lanes_t
+{
+    unsigned int v[4];
+};
+
+inline lanes_t load(const unsigned int* p) { lanes_t r; for (int i = 0; i < 4; i++) r.v[i] = p[i]; return r; }
+inline void store(unsigned int* p, const lanes_t& a) { for (int i = 0; i < 4; i++) p[i] = a.v[i]; }
+inline lanes_t splat(unsigned int x) { lanes_t r; for (int i = 0; i < 4; i++) r.v[i] = x; return r; }
+inline lanes_t add(const lanes_t& a, const lanes_t& b) { lanes_t r; for (int i = 0; i < 4; i++) r.v[i] = a.v[i] + b.v[i]; return r; }
+inline lanes_t band(const lanes_t& a, const lanes_t& b) { lanes_t r; for (int i = 0; i < 4; i++) r.v[i] = a.v[i] & b.v[i]; return r; }
+inline lanes_t bor(const lanes_t& a, const lanes_t& b) { lanes_t r; for (int i = 0; i < 4; i++) r.v[i] = a.v[i] | b.v[i]; return r; }
+inline lanes_t bxor(const lanes_t& a, const lanes_t& b) { lanes_t r; for (int i = 0; i < 4; i++) r.v[i] = a.v[i] ^ b.v[i]; return r; }
+inline lanes_t bandnot(const lanes_t& a, const lanes_t& b) { lanes_t r; for (int i = 0; i < 4; i++) r.v[i] = ~a.v[i] & b.v[i]; return r; }
+inline lanes_t srl(const lanes_t& a, int n) { lanes_t r; for (int i = 0; i < 4; i++) r.v[i] = a.v[i] >> n; return r; }
+inline lanes_t sll(const lanes_t& a, int n) { lanes_t r; for (int i = 0; i < 4; i++) r.v[i] = a.v[i] << n; return r; }
+inline lanes_t greater(const lanes_t& a, const lanes_t& b) { lanes_t r; for (int i = 0; i < 4; i++) r.v[i] = a.v[i] > b.v[i] ? ~0u : 0u; return r; }
+inline int equal(const lanes_t& a, const lanes_t& b) { int r = 0; for (int i = 0; i < 4; i++) r |= (a.v[i] == b.v[i]) << i; return r; }
+inline lanes_t ringSource(const lanes_t& a) { lanes_t r = { { a.v[2], a.v[0], a.v[1], a.v[3] } }; return r; }
+
+#endif
+
+}
+
+VoiceKernel::VoiceKernel(Voice* voice1, Voice* voice2, Voice* voice3)
+{
+    wave[0] = voice1->wave();
+    wave[1] = voice2->wave();
+    wave[2] = voice3->wave();
+
+    envelope[0] = voice1->envelope();
+    envelope[1] = voice2->envelope();
+    envelope[2] = voice3->envelope();
+}
+
+bool VoiceKernel::vectorized()
+{
+#ifdef __SSE2__
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool VoiceKernel::clock(unsigned int n, int* const output[3])
+{
+    for (int v = 0; v < 3; v++)
+    {
+        if (wave[v]->test || wave[v]->waveform > 0x8)
+        {
+            return false;
+        }
+    }
+
+    if (n == 0)
+    {
+        return true;
+    }
+
+    // The fourth lane is padding, its events are masked out
+    unsigned int accumulator[4] = { 0, 0, 0, 0 };
+    unsigned int freq[4] = { 0, 0, 0, 0 };
+    unsigned int pw[4] = { 0, 0, 0, 0 };
+    unsigned int ring_msb_mask[4] = { 0, 0, 0, 0 };
+    unsigned int pulse_output[4] = { 0, 0, 0, 0 };
+    unsigned int lfsr[4] = { 0, 0, 0, 0 };
+    unsigned int rate[4] = { 0, 0, 0, 0 };
+    unsigned int stepped[4];
+    unsigned int ix[4];
+    unsigned int msb[4];
+    int shift_pipeline[3];
+    float envelope_output[3];
+
+    int shiftPending = 0;
+    int envelopePending = 0;
+
+    for (int v = 0; v < 3; v++)
+    {
+        accumulator[v] = wave[v]->accumulator;
+        freq[v] = wave[v]->freq;
+        pw[v] = wave[v]->pw;
+        ring_msb_mask[v] = wave[v]->ring_msb_mask;
+        pulse_output[v] = wave[v]->pulse_output;
+        shift_pipeline[v] = wave[v]->shift_pipeline;
+
+        if (shift_pipeline[v] != 0)
+            shiftPending |= 1 << v;
+
+        lfsr[v] = envelope[v]->lfsr;
+        rate[v] = envelope[v]->rate;
+        envelope_output[v] = envelope[v]->output();
+
+        if (envelope[v]->envelope_pipeline)
+            envelopePending |= 1 << v;
+    }
+
+    const lanes_t accumulatorMask = splat(0xffffff);
+    const lanes_t bit19 = splat(0x080000);
+    const lanes_t lfsrFeedback = splat(0x4000);
+    const lanes_t pulseMask = splat(0xfff);
+    const lanes_t vfreq = load(freq);
+    const lanes_t vpw = load(pw);
+    const lanes_t vring = load(ring_msb_mask);
+
+    lanes_t acc = load(accumulator);
+    lanes_t bits_set = splat(0);
+    lanes_t vlfsr = load(lfsr);
+    lanes_t vrate = load(rate);
+
+    for (unsigned int i = 0; i < n; i++)
+    {
+        /* clock waveform generators */
+        const lanes_t accumulator_old = acc;
+        acc = band(add(acc, vfreq), accumulatorMask);
+        bits_set = bandnot(accumulator_old, acc);
+
+        const int bit19Rising = equal(band(bits_set, bit19), bit19) & 0x7;
+
+        if (unlikely((bit19Rising | shiftPending) != 0))
+        {
+            for (int v = 0; v < 3; v++)
+            {
+                if (bit19Rising & (1 << v))
+                {
+                    shift_pipeline[v] = 2;
+                    shiftPending |= 1 << v;
+                }
+                else if ((shiftPending & (1 << v)) && --shift_pipeline[v] == 0)
+                {
+                    wave[v]->clock_shift_register();
+                    shiftPending &= ~(1 << v);
+                }
+            }
+        }
+
+        /* clock envelope generators */
+        const int envelopeEvent = (equal(vlfsr, vrate) & 0x7) | envelopePending;
+        const lanes_t feedback = band(bxor(sll(vlfsr, 14), sll(vlfsr, 13)), lfsrFeedback);
+        const lanes_t vstepped = bor(srl(vlfsr, 1), feedback);
+
+        if (likely(envelopeEvent == 0))
+        {
+            vlfsr = vstepped;
+        }
+        else
+        {
+            store(lfsr, vlfsr);
+            store(stepped, vstepped);
+
+            for (int v = 0; v < 3; v++)
+            {
+                if (envelopeEvent & (1 << v))
+                {
+                    EnvelopeGenerator* const env = envelope[v];
+                    env->lfsr = lfsr[v];
+                    env->clock();
+                    lfsr[v] = env->lfsr;
+                    rate[v] = env->rate;
+                    envelope_output[v] = env->output();
+
+                    if (env->envelope_pipeline)
+                        envelopePending |= 1 << v;
+                    else
+                        envelopePending &= ~(1 << v);
+                }
+                else
+                {
+                    lfsr[v] = stepped[v];
+                }
+            }
+
+            vlfsr = load(lfsr);
+            vrate = load(rate);
+        }
+
+        /* voice outputs */
+        store(ix, srl(bxor(acc, band(ringSource(acc), vring)), 12));
+
+        for (int v = 0; v < 3; v++)
+        {
+            WaveformGenerator* const w = wave[v];
+
+            if (likely(w->waveform != 0))
+            {
+                w->waveform_output = w->wave[ix[v]] & (w->no_pulse | pulse_output[v]) & w->no_noise_or_noise_output;
+            }
+            else if (likely(w->floating_output_ttl != 0) && unlikely(--w->floating_output_ttl == 0))
+            {
+                w->waveform_output = 0;
+            }
+
+            output[v][i] = static_cast<int>(w->dac[w->waveform_output] * envelope_output[v] + 0.5f);
+        }
+
+        // The result of the pulse width compare is delayed one cycle.
+        store(pulse_output, bandnot(greater(vpw, srl(acc, 12)), pulseMask));
+    }
+
+    store(accumulator, acc);
+    store(lfsr, vlfsr);
+    store(msb, bits_set);
+
+    for (int v = 0; v < 3; v++)
+    {
+        wave[v]->accumulator = accumulator[v];
+        wave[v]->msb_rising = (msb[v] & 0x800000) != 0;
+        wave[v]->pulse_output = pulse_output[v];
+        wave[v]->shift_pipeline = shift_pipeline[v];
+        envelope[v]->lfsr = lfsr[v];
+    }
+
+    return true;
+}
+
+} // namespace reSIDfp
@@ -0,0 +1,84 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2015 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef VOICEKERNEL_H
+#define VOICEKERNEL_H
+
+namespace reSIDfp
+{
+
+class Voice;
+class WaveformGenerator;
+class EnvelopeGenerator;
+
+/**
+ * Clocks the three voices together, one lane per voice.
+ *
+ * The accumulators, frequencies, pulse widths, pulse levels,
+ * ring modulation masks and envelope shift registers are loaded
+ * into structure-of-arrays form at the start of each block,
+ * so that the accumulator step, the bit 19 and MSB edge detection,
+ * the pulse width compare and the envelope LFSR step run with
+ * SSE2 instructions, or a plain loop over the lanes elsewhere.
+ *
+ * Rare events, that is noise shift register clocking and
+ * envelope rate counter matches, are handed to the generators
+ * of the lanes involved, so the result is the same as
+ * clocking each voice on its own.
+ * Blocks where a voice has the test bit set or a combined waveform
+ * with noise writing back into the shift register are refused
+ * and must be clocked by the scalar code.
+ */
+class VoiceKernel
+{
+private:
+    WaveformGenerator* wave[3];
+
+    EnvelopeGenerator* envelope[3];
+
+public:
+    /**
+     * Constructor.
+     *
+     * @param voice1 first voice
+     * @param voice2 second voice
+     * @param voice3 third voice
+     */
+    VoiceKernel(Voice* voice1, Voice* voice2, Voice* voice3);
+
+    /**
+     * Tell whether vector instructions are used on this platform.
+     */
+    static bool vectorized();
+
+    /**
+     * Clock the waveform and envelope generators
+     * and store the voice outputs of each cycle.
+     *
+     * @param n the number of cycles
+     * @param output the arrays where to store the output of each voice
+     * @return false if the block can't be handled, nothing is clocked then
+     */
+    bool clock(unsigned int n, int* const output[3]);
+};
+
+} // namespace reSIDfp
+
+#endif
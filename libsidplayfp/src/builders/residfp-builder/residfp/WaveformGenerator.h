@@ -85,6 +85,8 @@ namespace reSIDfp
  */
 class WaveformGenerator
 {
+    friend class VoiceKernel;
+
 private:
     matrix_t* model_wave;
 
@@ -48,21 +48,26 @@ public:
     virtual bool input(int sample) = 0;
 
     /**
-     * Output a sample from resampler.
+     * Clip signed integer value into the -32768,32767 range.
      *
-     * @return resampled sample
+     * @param value the value to clip
+     * @return the clipped value
      */
-    short getOutput() const
+    static short clip(int value)
     {
-        int value = output();
-
-        // Clip signed integer value into the -32768,32767 range.
         if (value < -32768) value = -32768;
         if (value > 32767) value = 32767;
 
         return value;
     }
 
+    /**
+     * Output a sample from resampler.
+     *
+     * @return resampled sample
+     */
+    short getOutput() const { return clip(output()); }
+
     virtual void reset() = 0;
 };
 
@@ -20,6 +20,8 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
  */
 
+#define SINCRESAMPLER_CPP
+
 #include "SincResampler.h"
 
 #include <cassert>
@@ -228,25 +230,6 @@ SincResampler::SincResampler(double clockFrequency, double samplingFrequency, do
     }
 }
 
-bool SincResampler::input(int input)
-{
-    bool ready = false;
-
-    sample[sampleIndex] = sample[sampleIndex + RINGSIZE] = input;
-    sampleIndex = (sampleIndex + 1) & (RINGSIZE - 1);
-
-    if (sampleOffset < 1024)
-    {
-        outputValue = fir(sampleOffset);
-        ready = true;
-        sampleOffset += cyclesPerSample;
-    }
-
-    sampleOffset -= 1024;
-
-    return ready;
-}
-
 void SincResampler::reset()
 {
     memset(sample, 0, RINGSIZE * 2 * sizeof(sample[0]));
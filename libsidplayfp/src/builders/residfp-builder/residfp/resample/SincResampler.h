@@ -23,6 +23,8 @@
 #ifndef SINCRESAMPLER_H
 #define SINCRESAMPLER_H
 
+#include "siddefs-fp.h"
+
 #include "Resampler.h"
 
 #include <string>
@@ -109,4 +111,33 @@ public:
 
 } // namespace reSIDfp
 
+#if RESID_INLINING || defined(SINCRESAMPLER_CPP)
+
+namespace reSIDfp
+{
+
+RESID_INLINE
+bool SincResampler::input(int input)
+{
+    bool ready = false;
+
+    sample[sampleIndex] = sample[sampleIndex + RINGSIZE] = input;
+    sampleIndex = (sampleIndex + 1) & (RINGSIZE - 1);
+
+    if (sampleOffset < 1024)
+    {
+        outputValue = fir(sampleOffset);
+        ready = true;
+        sampleOffset += cyclesPerSample;
+    }
+
+    sampleOffset -= 1024;
+
+    return ready;
+}
+
+} // namespace reSIDfp
+
+#endif
+
 #endif
@@ -60,12 +60,12 @@ public:
 
     bool input(int sample)
     {
-        return s1->input(sample) && s2->input(s1->output());
+        return s1->SincResampler::input(sample) && s2->SincResampler::input(s1->SincResampler::output());
     }
 
     int output() const
     {
-        return s2->output();
+        return s2->SincResampler::output();
     }
 
     void reset()
@@ -23,6 +23,7 @@
 #define BANK_H
 
 #include <stdint.h>
+#include <climits>
 
 #include "sidplayfp/siddefs.h"
 
@@ -57,6 +58,19 @@ public:
      */
     virtual uint8_t peek(uint_least16_t address) =0;
 
+    /**
+     * Check for how many cycles reading an address keeps returning
+     * the value just read, provided nothing is written and no event
+     * fires in the meantime. The CPU uses this to skip loops polling
+     * the I/O chips. By default the value may change at any time.
+     *
+     * @param address the address just read
+     * @param value the value returned by peek
+     * @return the number of cycles, 0 if the value may change at any time,
+     *         UINT_MAX if it only changes in events
+     */
+    virtual unsigned int stableCycles(uint_least16_t address SID_UNUSED, uint8_t value SID_UNUSED) const { return 0; }
+
 protected:
     ~Bank() {}
 };
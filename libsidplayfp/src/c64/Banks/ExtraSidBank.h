@@ -26,6 +26,8 @@
 #include <algorithm>
 
 #include "c64/c64sid.h"
+#include "c64/sidcapture.h"
+#include "chrometrace.h"
 
 #include "sidcxx11.h"
 
@@ -55,14 +57,30 @@ private:
      */
     Bank *mapper[MAPPER_SIZE];
 
+    /**
+     * Number of the SID chip mapped at each base address,
+     * -1 for the underlying bank.
+     */
+    int chips[MAPPER_SIZE];
+
     sids_t sids;
 
+    /// Tracing sink, null if tracing is disabled
+    ChromeTrace *trace;
+
+    /// Register write capture, null if disabled
+    SidCapture *capture;
+
 private:
     static void resetSID(sids_t::value_type &e) { e->reset(0xf); }
 
     static unsigned int mapperIndex(int address) { return address >> 5 & (MAPPER_SIZE - 1); }
 
 public:
+    ExtraSidBank() :
+        trace(nullptr),
+        capture(nullptr) {}
+
     virtual ~ExtraSidBank() {}
 
     void reset()
@@ -73,7 +91,10 @@ public:
     void resetSIDMapper(Bank *bank)
     {
         for (int i = 0; i < MAPPER_SIZE; i++)
+        {
             mapper[i] = bank;
+            chips[i] = -1;
+        }
     }
 
     uint8_t peek(uint_least16_t addr) override
@@ -83,7 +104,18 @@ public:
 
     void poke(uint_least16_t addr, uint8_t data) override
     {
-        mapper[mapperIndex(addr)]->poke(addr, data);
+        const unsigned int index = mapperIndex(addr);
+
+        // Writes to the underlying bank are traced there, if needed
+        if (chips[index] >= 0)
+        {
+            if (trace != nullptr)
+                trace->sidWrite(addr, data);
+            if (capture != nullptr)
+                capture->write(chips[index], addr, data);
+        }
+
+        mapper[index]->poke(addr, data);
     }
 
     /**
@@ -91,12 +123,28 @@ public:
      *
      * @param s the emulation
      * @param address the address where to put the chip
+     * @param chip the chip number
      */
-    void addSID(c64sid *s, int address)
+    void addSID(c64sid *s, int address, int chip)
     {
         sids.push_back(s);
         mapper[mapperIndex(address)] = s;
+        chips[mapperIndex(address)] = chip;
     }
+
+    /**
+     * Set the tracing sink for register writes.
+     *
+     * @param t the sink, null to disable tracing
+     */
+    void setTrace(ChromeTrace *t) { trace = t; }
+
+    /**
+     * Set the capture of the register writes.
+     *
+     * @param c the capture, null to disable capturing
+     */
+    void setCapture(SidCapture *c) { capture = c; }
 };
 
 }
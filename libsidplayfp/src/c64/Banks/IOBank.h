@@ -61,6 +61,11 @@ public:
     {
         map[addr >> 8 & 0xf]->poke(addr, data);
     }
+
+    unsigned int stableCycles(uint_least16_t addr, uint8_t data) const override
+    {
+        return map[addr >> 8 & 0xf]->stableCycles(addr, data);
+    }
 };
 
 }
@@ -0,0 +1,73 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2015 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef RECORDINGSID_H
+#define RECORDINGSID_H
+
+#include "c64/c64sid.h"
+
+#include "sidcxx11.h"
+
+namespace libsidplayfp
+{
+
+/**
+ * SID chip placeholder which does no synthesis at all,
+ * for capturing the register writes at full speed.
+ *
+ * Reads return the last value written to the chip,
+ * like the write only registers of the real chip,
+ * except the paddles which read as 0xff.
+ * The oscillator and envelope of voice 3 can't be read back.
+ */
+class RecordingSid final : public c64sid
+{
+private:
+    uint8_t busValue;
+
+public:
+    RecordingSid() :
+        busValue(0) {}
+
+    virtual ~RecordingSid() {}
+
+    void reset(uint8_t) override { busValue = 0; }
+
+    void write(uint_least8_t, uint8_t data) override { busValue = data; }
+
+    uint8_t read(uint_least8_t addr) override
+    {
+        switch (addr)
+        {
+        case 0x19:
+        case 0x1a:
+            return 0xff;
+        case 0x1b:
+        case 0x1c:
+            return 0;
+        default:
+            return busValue;
+        }
+    }
+};
+
+}
+
+#endif // RECORDINGSID_H
@@ -24,6 +24,8 @@
 
 #include "Bank.h"
 #include "c64/c64sid.h"
+#include "c64/sidcapture.h"
+#include "chrometrace.h"
 
 #include "sidcxx11.h"
 
@@ -43,9 +45,17 @@ private:
     /// SID chip
     c64sid *sid;
 
+    /// Tracing sink, null if tracing is disabled
+    ChromeTrace *trace;
+
+    /// Register write capture, null if disabled
+    SidCapture *capture;
+
 public:
     SidBank()
-      : sid(NullSid::getInstance())
+      : sid(NullSid::getInstance()),
+        trace(nullptr),
+        capture(nullptr)
     {}
 
     void reset()
@@ -60,6 +70,11 @@ public:
 
     void poke(uint_least16_t addr, uint8_t data) override
     {
+        if (trace != nullptr)
+            trace->sidWrite(addr, data);
+        if (capture != nullptr)
+            capture->write(0, addr, data);
+
         sid->poke(addr, data);
     }
 
@@ -69,6 +84,20 @@ public:
      * @param s the emulation
      */
     void setSID(c64sid *s) { sid = (s != nullptr) ? s : NullSid::getInstance(); }
+
+    /**
+     * Set the tracing sink for register writes.
+     *
+     * @param t the sink, null to disable tracing
+     */
+    void setTrace(ChromeTrace *t) { trace = t; }
+
+    /**
+     * Set the capture of the register writes.
+     *
+     * @param c the capture, null to disable capturing
+     */
+    void setCapture(SidCapture *c) { capture = c; }
 };
 
 }
@@ -25,14 +25,125 @@
 #include <stdint.h>
 #include <cstring>
 
+#include <algorithm>
+
 #include "Bank.h"
 
+#include "sidcxx11.h"
+
 namespace libsidplayfp
 {
 
+/**
+ * A 256 byte page of RAM, shared copy-on-write
+ * between the machine and the snapshots.
+ */
+struct RamPage
+{
+    /// Number of owners
+    unsigned int refs;
+
+    uint8_t data[0x100];
+
+    static RamPage* create()
+    {
+        RamPage* page = new RamPage;
+        page->refs = 1;
+        return page;
+    }
+
+    RamPage* share()
+    {
+        refs++;
+        return this;
+    }
+
+    void release()
+    {
+        if (--refs == 0)
+            delete this;
+    }
+};
+
+/**
+ * Image of the RAM at some point in time.
+ * It holds references to the pages, so copies are cheap.
+ */
+class RamSnapshot
+{
+    friend class SystemRAMBank;
+
+private:
+    RamPage* pages[0x100];
+
+private:
+    void assign(RamPage* const* source)
+    {
+        for (unsigned int page = 0; page < 0x100; page++)
+        {
+            if (pages[page] != source[page])
+            {
+                if (pages[page] != nullptr)
+                    pages[page]->release();
+                pages[page] = source[page] != nullptr ? source[page]->share() : nullptr;
+            }
+        }
+    }
+
+public:
+    RamSnapshot()
+    {
+        for (unsigned int page = 0; page < 0x100; page++)
+            pages[page] = nullptr;
+    }
+
+    RamSnapshot(const RamSnapshot &other)
+    {
+        for (unsigned int page = 0; page < 0x100; page++)
+            pages[page] = nullptr;
+        assign(other.pages);
+    }
+
+    ~RamSnapshot()
+    {
+        for (unsigned int page = 0; page < 0x100; page++)
+        {
+            if (pages[page] != nullptr)
+                pages[page]->release();
+        }
+    }
+
+    RamSnapshot &operator=(const RamSnapshot &other)
+    {
+        assign(other.pages);
+        return *this;
+    }
+
+    /**
+     * Check if the snapshot has been taken.
+     */
+    bool empty() const { return pages[0] == nullptr; }
+
+    /**
+     * Copy the 64k image.
+     *
+     * @param buffer the destination
+     */
+    void read(uint8_t* buffer) const
+    {
+        for (unsigned int page = 0; page < 0x100; page++)
+            memcpy(buffer + (page << 8), pages[page]->data, 0x100);
+    }
+};
+
 /**
  * Area backed by RAM.
  *
+ * The RAM is split in 256 byte pages which are shared
+ * with the snapshots and copied on the first write,
+ * so a snapshot only costs a walk of the page table
+ * and later a copy of each page touched.
+ *
  * @author Antti Lankila
  */
 class SystemRAMBank : public Bank
@@ -41,29 +152,152 @@ class SystemRAMBank : public Bank
 
 private:
     /// C64 RAM area
-    uint8_t ram[0x10000];
+    RamPage* pages[0x100];
+
+    /// Page with the powerup pattern, shared by all pages after a reset
+    RamPage* powerupPage;
+
+private:
+    /**
+     * Give a page its own copy before writing to it.
+     */
+    uint8_t* unshare(unsigned int page)
+    {
+        RamPage* p = pages[page];
+        if (p->refs > 1)
+        {
+            RamPage* copy = RamPage::create();
+            memcpy(copy->data, p->data, 0x100);
+            p->release();
+            pages[page] = p = copy;
+        }
+        return p->data;
+    }
+
+    // prevent copying
+    SystemRAMBank(const SystemRAMBank&);
+    SystemRAMBank& operator=(const SystemRAMBank&);
 
 public:
+    SystemRAMBank() :
+        powerupPage(RamPage::create())
+    {
+        memset(powerupPage->data, 0, 0x100);
+        memset(powerupPage->data + 0x40, 0xff, 0x40);
+        memset(powerupPage->data + 0xc0, 0xff, 0x40);
+
+        for (unsigned int page = 0; page < 0x100; page++)
+            pages[page] = powerupPage->share();
+    }
+
+    ~SystemRAMBank()
+    {
+        for (unsigned int page = 0; page < 0x100; page++)
+            pages[page]->release();
+        powerupPage->release();
+    }
+
+    /**
+     * Get the content of a page.
+     *
+     * @param page the page number
+     */
+    const uint8_t* page(unsigned int page) const { return pages[page]->data; }
+
+    /**
+     * Get the content of a page for writing.
+     *
+     * @param page the page number
+     * @return the content, null if the page is shared
+     */
+    uint8_t* writablePage(unsigned int page) const
+    {
+        return pages[page]->refs == 1 ? pages[page]->data : nullptr;
+    }
+
+
+    /**
+     * Fill an area with a value.
+     *
+     * @param start the first address
+     * @param value the value
+     * @param size the size of the area
+     */
+    void fill(uint_least16_t start, uint8_t value, unsigned int size)
+    {
+        for (unsigned int addr = start; addr < start + size && addr < 0x10000; )
+        {
+            const unsigned int length = std::min(0x100 - (addr & 0xff), start + size - addr);
+            memset(unshare(addr >> 8) + (addr & 0xff), value, length);
+            addr += length;
+        }
+    }
+
+    /**
+     * Copy data into an area.
+     *
+     * @param start the first address
+     * @param source the data
+     * @param size the size of the area
+     */
+    void fill(uint_least16_t start, const uint8_t* source, unsigned int size)
+    {
+        for (unsigned int addr = start; addr < start + size && addr < 0x10000; )
+        {
+            const unsigned int length = std::min(0x100 - (addr & 0xff), start + size - addr);
+            memcpy(unshare(addr >> 8) + (addr & 0xff), source + (addr - start), length);
+            addr += length;
+        }
+    }
+
     /**
      * Initialize RAM with powerup pattern.
      */
     void reset()
     {
-        memset(ram, 0, 0x10000);
-        for (int i = 0x40; i < 0x10000; i += 0x80)
+        for (unsigned int page = 0; page < 0x100; page++)
+        {
+            pages[page]->release();
+            pages[page] = powerupPage->share();
+        }
+    }
+
+    /**
+     * Take a snapshot of the RAM.
+     * Reusing the previous snapshot only updates the pages written since.
+     *
+     * @param snapshot the snapshot to update
+     */
+    void save(RamSnapshot &snapshot) const
+    {
+        snapshot.assign(pages);
+    }
+
+    /**
+     * Restore a snapshot of the RAM.
+     *
+     * @param snapshot the snapshot, must not be empty
+     */
+    void restore(const RamSnapshot &snapshot)
+    {
+        for (unsigned int page = 0; page < 0x100; page++)
         {
-            memset(ram+i, 0xff, 0x40);
+            if (pages[page] != snapshot.pages[page])
+            {
+                pages[page]->release();
+                pages[page] = snapshot.pages[page]->share();
+            }
         }
     }
 
     uint8_t peek(uint_least16_t address) override
     {
-        return ram[address];
+        return pages[address >> 8]->data[address & 0xff];
     }
 
     void poke(uint_least16_t address, uint8_t value) override
     {
-        ram[address] = value;
+        unshare(address >> 8)[address & 0xff] = value;
     }
 };
 
@@ -72,6 +72,11 @@ public:
     void poke(uint_least16_t, uint8_t) override {}
 
     uint8_t peek(uint_least16_t address) override { return rom[address & (N-1)]; }
+
+    /**
+     * Return pointer to the 256 byte page containing the address.
+     */
+    const uint8_t* page(uint_least16_t address) const { return &rom[address & (N-1) & 0xff00]; }
 };
 
 /**
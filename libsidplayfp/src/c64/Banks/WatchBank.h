@@ -0,0 +1,83 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2015 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef WATCHBANK_H
+#define WATCHBANK_H
+
+#include <stdint.h>
+
+#include "Bank.h"
+#include "c64/watchpoints.h"
+
+#include "sidcxx11.h"
+
+namespace libsidplayfp
+{
+
+/**
+ * Instrumented wrapper of a bank, reporting the accesses
+ * to the watchpoints.
+ */
+class WatchBank final : public Bank
+{
+private:
+    Bank *bank;
+
+    Watchpoints *watchpoints;
+
+public:
+    WatchBank() :
+        bank(nullptr),
+        watchpoints(nullptr) {}
+
+    /**
+     * Wrap a bank.
+     *
+     * @param b the bank to wrap
+     * @param w the watchpoints to report to
+     */
+    void set(Bank *b, Watchpoints *w)
+    {
+        bank = b;
+        watchpoints = w;
+    }
+
+    /**
+     * Get the wrapped bank.
+     */
+    Bank *target() const { return bank; }
+
+    uint8_t peek(uint_least16_t address) override
+    {
+        const uint8_t value = bank->peek(address);
+        watchpoints->check(address, value, WATCH_READ);
+        return value;
+    }
+
+    void poke(uint_least16_t address, uint8_t value) override
+    {
+        watchpoints->check(address, value, WATCH_WRITE);
+        bank->poke(address, value);
+    }
+};
+
+}
+
+#endif
@@ -168,6 +168,16 @@ public:
         updateCpuPort();
     }
 
+    /**
+     * Get the data direction register, without side effects.
+     */
+    uint8_t getDir() const { return dir; }
+
+    /**
+     * Get the data register as last written, without side effects.
+     */
+    uint8_t getData() const { return data; }
+
     // $00/$01 unused bits emulation, as investigated by groepaz:
     //
     // - There are 2 different unused bits, 1) the output bits, 2) the input bits
@@ -24,6 +24,7 @@
 #include "mos6526.h"
 
 #include <cstring>
+#include <climits>
 
 #include "sidendian.h"
 
@@ -86,7 +87,7 @@ const char *MOS6526::credit =
     "\tCopyright (C) 2011-2014 Leandro Nini\n"
 };
 
-MOS6526::MOS6526(EventContext *context) :
+MOS6526::MOS6526(event_context_t *context) :
     event_context(*context),
     pra(regs[PRA]),
     prb(regs[PRB]),
@@ -216,6 +217,28 @@ uint8_t MOS6526::read(uint_least8_t addr)
     }
 }
 
+unsigned int MOS6526::stableCycles(uint_least8_t addr, uint8_t data) const
+{
+    switch (addr & 0x0f)
+    {
+    case TAL:
+        return timerA.isCounting() ? 0 : UINT_MAX;
+    case TAH:
+        // The high byte changes when the low byte wraps around
+        return timerA.isCounting() ? endian_16lo8(timerA.getTimer()) : UINT_MAX;
+    case TBL:
+        return timerB.isCounting() ? 0 : UINT_MAX;
+    case TBH:
+        return timerB.isCounting() ? endian_16lo8(timerB.getTimer()) : UINT_MAX;
+    case IDR:
+        // Reading clears the interrupt data register
+        return data == 0 ? UINT_MAX : 0;
+    default:
+        // Everything else changes only with writes and in events
+        return UINT_MAX;
+    }
+}
+
 void MOS6526::write(uint_least8_t addr, uint8_t data)
 {
     addr &= 0x0f;
@@ -33,8 +33,6 @@
 
 #include "sidcxx11.h"
 
-class EventContext;
-
 namespace libsidplayfp
 {
 
@@ -60,7 +58,7 @@ public:
     /**
      * Create timer A.
      */
-    TimerA(EventContext *context, MOS6526* parent) :
+    TimerA(event_context_t *context, MOS6526* parent) :
         Timer("CIA Timer A", context, parent) {}
 };
 
@@ -79,7 +77,7 @@ public:
     /**
      * Create timer B.
      */
-    TimerB(EventContext *context, MOS6526* parent) :
+    TimerB(event_context_t *context, MOS6526* parent) :
         Timer("CIA Timer B", context, parent) {}
 
     /**
@@ -118,7 +116,7 @@ private:
 
 protected:
     /// Event context.
-    EventContext &event_context;
+    event_context_t &event_context;
 
     /// These are all CIA registers.
     uint8_t regs[0x10];
@@ -215,7 +213,7 @@ protected:
      *
      * @param context the event context
      */
-    MOS6526(EventContext *context);
+    MOS6526(event_context_t *context);
     ~MOS6526() {}
 
     /**
@@ -247,6 +245,18 @@ protected:
      */
     void write(uint_least8_t addr, uint8_t data) override;
 
+    /**
+     * Get for how many cycles reading a CIA register keeps
+     * returning the value just read if no event fires.
+     *
+     * @param addr
+     *            register address just read (lowest 4 bits)
+     * @param data
+     *            value read
+     * @return the number of cycles, UINT_MAX if it only changes in events
+     */
+    unsigned int stableCycles(uint_least8_t addr, uint8_t data) const;
+
 public:
     /**
      * Reset CIA.
@@ -64,7 +64,7 @@ private:
     EventCallback<Timer> m_cycleSkippingEvent;
 
     /// Event context.
-    EventContext &event_context;
+    event_context_t &event_context;
 
     /**
      * This is a tri-state:
@@ -136,7 +136,7 @@ protected:
      * @param context event context
      * @param parent the MOS6526 which this Timer belongs to
      */
-    Timer(const char* name, EventContext *context, MOS6526* parent) :
+    Timer(const char* name, event_context_t *context, MOS6526* parent) :
         Event(name),
         m_cycleSkippingEvent("Skip CIA clock decrement cycles", *this, &Timer::cycleSkippingEvent),
         event_context(*context),
@@ -212,6 +212,19 @@ public:
      */
     inline uint_least16_t getTimer() const { return timer; }
 
+    /**
+     * Check if the timer is counting down at each cycle,
+     * or about to start to. Otherwise its value
+     * only changes with writes and in events.
+     *
+     * @return true if the timer is counting
+     */
+    inline bool isCounting() const
+    {
+        return (state & (CIAT_COUNT2 | CIAT_COUNT3)) != 0
+            || (state & (CIAT_CR_START | CIAT_PHI2IN)) == (CIAT_CR_START | CIAT_PHI2IN);
+    }
+
     /**
      * Get PB6/PB7 Flipflop state.
      *
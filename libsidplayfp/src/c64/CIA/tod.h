@@ -26,7 +26,7 @@
 
 #include <stdint.h>
 
-#include "sidplayfp/event.h"
+#include "EventScheduler.h"
 
 namespace libsidplayfp
 {
@@ -49,7 +49,7 @@ private:
 
 private:
     /// Event context.
-    EventContext &event_context;
+    event_context_t &event_context;
 
     /// Pointer to the MOS6526 which this Timer belongs to.
     MOS6526* const parent;
@@ -73,7 +73,7 @@ private:
     void event();
 
 public:
-    Tod(EventContext *context, MOS6526* parent, uint8_t regs[0x10]) :
+    Tod(event_context_t *context, MOS6526* parent, uint8_t regs[0x10]) :
         Event("CIA Time of Day"),
         event_context(*context),
         parent(parent),
@@ -27,17 +27,25 @@
 
 #include "opcodes.h"
 
+#ifdef CPU_SWITCH_DISPATCH
+#  include <cassert>
+#  include <vector>
+#endif
+
 #ifdef DEBUG
 #  include <cstdio>
 #  include "mos6510debug.h"
 #endif
 
+#ifdef PC64_TESTSUITE
+#  include <cstdio>
+#  include <cstdlib>
+#endif
+
 namespace libsidplayfp
 {
 
 #ifdef PC64_TESTSUITE
-#  include <stdlib.h>
-
 /**
  * CHR$ conversion table (0x01 = no output)
  */
@@ -84,29 +92,263 @@ const uint8_t magic =
 ;
 //-------------------------------------------------------------------------//
 
+#ifdef CPU_SWITCH_DISPATCH
+
 /**
- * When AEC signal is high, no stealing is possible.
+ * All the cycle handlers, in micro-op id order.
  */
-void MOS6510::eventWithoutSteals()
+#define MICRO_OPS(X) \
+    X(throwAwayFetch) \
+    X(FetchDataByte) \
+    X(FetchLowAddr) \
+    X(FetchLowAddrX) \
+    X(WasteCycle) \
+    X(FetchLowAddrY) \
+    X(FetchHighAddr) \
+    X(FetchHighAddrX2) \
+    X(throwAwayRead) \
+    X(FetchHighAddrX) \
+    X(FetchHighAddrY2) \
+    X(FetchHighAddrY) \
+    X(FetchLowPointer) \
+    X(FetchHighPointer) \
+    X(FetchLowEffAddr) \
+    X(FetchHighEffAddr) \
+    X(FetchLowPointerX) \
+    X(FetchHighEffAddrY2) \
+    X(FetchHighEffAddrY) \
+    X(FetchEffAddrDataByte) \
+    X(adc_instr) \
+    X(anc_instr) \
+    X(and_instr) \
+    X(ane_instr) \
+    X(arr_instr) \
+    X(asla_instr) \
+    X(asl_instr) \
+    X(PutEffAddrDataByte) \
+    X(alr_instr) \
+    X(bcc_instr) \
+    X(bcs_instr) \
+    X(beq_instr) \
+    X(bit_instr) \
+    X(bmi_instr) \
+    X(bne_instr) \
+    X(bpl_instr) \
+    X(PushHighPC) \
+    X(brkPushLowPC) \
+    X(brk_instr) \
+    X(IRQLoRequest) \
+    X(IRQHiRequest) \
+    X(fetchNextOpcode) \
+    X(bvc_instr) \
+    X(bvs_instr) \
+    X(clc_instr) \
+    X(cld_instr) \
+    X(cli_instr) \
+    X(clv_instr) \
+    X(cmp_instr) \
+    X(cpx_instr) \
+    X(cpy_instr) \
+    X(dcm_instr) \
+    X(dec_instr) \
+    X(dex_instr) \
+    X(dey_instr) \
+    X(eor_instr) \
+    X(inc_instr) \
+    X(inx_instr) \
+    X(iny_instr) \
+    X(ins_instr) \
+    X(PushLowPC) \
+    X(jmp_instr) \
+    X(las_instr) \
+    X(lax_instr) \
+    X(lda_instr) \
+    X(ldx_instr) \
+    X(ldy_instr) \
+    X(lsra_instr) \
+    X(lsr_instr) \
+    X(oal_instr) \
+    X(ora_instr) \
+    X(pha_instr) \
+    X(PushSR) \
+    X(pla_instr) \
+    X(PopSR) \
+    X(plp_instr) \
+    X(rla_instr) \
+    X(rola_instr) \
+    X(rol_instr) \
+    X(rora_instr) \
+    X(ror_instr) \
+    X(rra_instr) \
+    X(PopLowPC) \
+    X(PopHighPC) \
+    X(rti_instr) \
+    X(rts_instr) \
+    X(axs_instr) \
+    X(sbc_instr) \
+    X(sbx_instr) \
+    X(sec_instr) \
+    X(sed_instr) \
+    X(sei_instr) \
+    X(axa_instr) \
+    X(shs_instr) \
+    X(xas_instr) \
+    X(say_instr) \
+    X(aso_instr) \
+    X(lse_instr) \
+    X(sta_instr) \
+    X(stx_instr) \
+    X(sty_instr) \
+    X(tax_instr) \
+    X(tay_instr) \
+    X(tsx_instr) \
+    X(txa_instr) \
+    X(txs_instr) \
+    X(tya_instr) \
+    X(illegal_instr) \
+    X(interruptsAndNextOpcode)
+
+/**
+ * Micro-op ids, 0 marks unused cycles.
+ */
+enum
+{
+    MICRO_OP_NONE = 0,
+#define MICRO_OP_ID(f) MICRO_OP_##f,
+    MICRO_OPS(MICRO_OP_ID)
+#undef MICRO_OP_ID
+    MICRO_OP_COUNT
+};
+
+/// Flag marking the cycles where no stealing is possible
+const uint8_t MICRO_OP_NOSTEAL = 0x80;
+
+/// The micro-op ids must not overlap the flag
+typedef char micro_op_ids_fit[MICRO_OP_COUNT <= MICRO_OP_NOSTEAL ? 1 : -1];
+
+/**
+ * Execute a cycle. Being a plain switch the handlers
+ * can be inlined by the compiler.
+ */
+inline void MOS6510::dispatch(uint8_t microOp)
+{
+    switch (microOp & ~MICRO_OP_NOSTEAL)
+    {
+#define MICRO_OP_CASE(f) case MICRO_OP_##f: f(); break;
+    MICRO_OPS(MICRO_OP_CASE)
+#undef MICRO_OP_CASE
+    default:
+        // Unused cycle or handler missing from MICRO_OPS
+        assert(false);
+        break;
+    }
+}
+
+/**
+ * Convert the table built by the constructor to micro-op ids.
+ *
+ * @param instrTable the table of cycle handlers
+ */
+void MOS6510::buildMicroOpTable(const ProcessorCycle *instrTable)
+{
+    static const ProcessorCycle::func_t handlers[MICRO_OP_COUNT] =
+    {
+        nullptr,
+#define MICRO_OP_FUNC(f) &MOS6510::f,
+        MICRO_OPS(MICRO_OP_FUNC)
+#undef MICRO_OP_FUNC
+    };
+
+    for (int i = 0; i < (0x101 << 3); i++)
+    {
+        int id = 0;
+        while (id < MICRO_OP_COUNT && handlers[id] != instrTable[i].func)
+            id++;
+
+        // Every handler used in the table must be listed in MICRO_OPS
+        assert(id < MICRO_OP_COUNT);
+
+        microOpTable[i] = static_cast<uint8_t>(id) | (instrTable[i].nosteal ? MICRO_OP_NOSTEAL : 0);
+    }
+}
+
+/**
+ * Execute the current cycle and move to the next one.
+ */
+inline void MOS6510::executeCycle()
+{
+    dispatch(microOpTable[cycleCount++]);
+}
+
+/**
+ * Check if stealing is impossible in the current cycle.
+ */
+inline bool MOS6510::noStealCycle() const
+{
+    return microOpTable[cycleCount] & MICRO_OP_NOSTEAL;
+}
+
+#else
+
+/**
+ * Execute the current cycle and move to the next one.
+ */
+inline void MOS6510::executeCycle()
 {
     const ProcessorCycle &instr = instrTable[cycleCount++];
     (this->*(instr.func)) ();
+}
+
+/**
+ * Check if stealing is impossible in the current cycle.
+ */
+inline bool MOS6510::noStealCycle() const
+{
+    return instrTable[cycleCount].nosteal;
+}
+
+#endif
+
+/**
+ * When AEC signal is high, no stealing is possible.
+ *
+ * The rest of the instruction is executed within the same event
+ * as long as no other event is due before each cycle,
+ * falling back to one event per cycle otherwise.
+ * Nothing else can observe the CPU or change its inputs meanwhile
+ * since bus signals and interrupts are driven by events.
+ */
+void MOS6510::eventWithoutSteals()
+{
+    do
+    {
+        executeCycle();
+    }
+    while ((cycleCount & 7) != 0 && eventContext.advance(1));
+
     eventContext.schedule(m_nosteal, 1);
 }
 
 /**
  * When AEC signal is low, steals permitted.
+ *
+ * On the first read cycle the CPU stalls and is not rescheduled,
+ * it stays parked until setRDY wakes it up.
  */
 void MOS6510::eventWithSteals()
 {
-    if (instrTable[cycleCount].nosteal)
+    if (noStealCycle())
     {
-        const ProcessorCycle &instr = instrTable[cycleCount++];
-        (this->*(instr.func)) ();
+        executeCycle();
         eventContext.schedule(m_steal, 1);
     }
     else
     {
+        stalled = true;
+
+        // Stalled cycles are not repeated identically
+        idleLoopDirty = true;
+
         /* Even while stalled, the CPU can still process first clock of
         * interrupt delay, but only the first one. */
         if (interruptCycle == cycleCount)
@@ -126,9 +368,17 @@ void MOS6510::eventWithSteals()
 void MOS6510::setRDY(bool newRDY)
 {
     rdy = newRDY;
+    stalled = false;
 
     if (rdy)
     {
+        // The PHI2 where the interrupt delay was processed has not come yet
+        if (stalledInterruptClock == eventContext.getTime(EVENT_CLOCK_PHI2))
+        {
+            interruptCycle++;
+        }
+        stalledInterruptClock = -1;
+
         eventContext.cancel(m_steal);
         eventContext.schedule(m_nosteal, 0, EVENT_CLOCK_PHI2);
     }
@@ -200,8 +450,7 @@ void MOS6510::triggerNMI()
     /* maybe process 1 clock of interrupt delay. */
     if (!rdy)
     {
-        eventContext.cancel(m_steal);
-        eventContext.schedule(m_steal, 0, EVENT_CLOCK_PHI2);
+        stalledInterruptDelay();
     }
 }
 
@@ -215,6 +464,29 @@ void MOS6510::triggerIRQ()
 
     /* maybe process 1 clock of interrupt delay. */
     if (!rdy && interruptCycle == cycleCount)
+    {
+        stalledInterruptDelay();
+    }
+}
+
+/**
+ * Process the first clock of interrupt delay while RDY is low.
+ *
+ * If the CPU is parked the clock is accounted for right away
+ * instead of waking it up for the next PHI2, and given back
+ * if RDY goes high before that PHI2.
+ */
+void MOS6510::stalledInterruptDelay()
+{
+    if (stalled)
+    {
+        if (interruptCycle == cycleCount)
+        {
+            interruptCycle --;
+            stalledInterruptClock = eventContext.getTime(EVENT_CLOCK_PHI2);
+        }
+    }
+    else
     {
         eventContext.cancel(m_steal);
         eventContext.schedule(m_steal, 0, EVENT_CLOCK_PHI2);
@@ -244,6 +516,19 @@ void MOS6510::interruptsAndNextOpcode()
             MOS6510Debug::DumpState(cycles, *this);
         }
 #endif
+        if (m_trace != nullptr)
+            m_trace->interrupt(Register_ProgramCounter);
+        if (m_profiler != nullptr)
+            m_profiler->interrupt();
+        if (m_playTime != nullptr)
+            m_playTime->interrupt(Register_StackPointer);
+        if (m_cpuTrace != nullptr)
+            traceInstruction(CpuTraceRecord::INTERRUPT);
+
+        // The interrupt sequence is traced as a BRK
+        instrStartPC = Register_ProgramCounter;
+        instrOpcode = BRKn;
+
         cpuRead(Register_ProgramCounter);
         cycleCount = BRKn << 3;
         flags.B = false;
@@ -253,18 +538,154 @@ void MOS6510::interruptsAndNextOpcode()
     }
 }
 
+/**
+ * Pack registers and flags for comparison.
+ */
+uint_least64_t MOS6510::idleState()
+{
+    return static_cast<uint_least64_t>(Register_Accumulator)
+        | static_cast<uint_least64_t>(Register_X) << 8
+        | static_cast<uint_least64_t>(Register_Y) << 16
+        | static_cast<uint_least64_t>(Register_StackPointer) << 24
+        | static_cast<uint_least64_t>(flags.get()) << 32;
+}
+
+/**
+ * Check if each instruction is watched, traced, profiled or dumped,
+ * in which case idle loops must really be executed.
+ */
+bool MOS6510::observed() const
+{
+    return m_watchpoints != nullptr
+        || m_profiler != nullptr
+        || m_cpuTrace != nullptr
+        || m_trace != nullptr
+#ifdef DEBUG
+        || dodump
+#endif
+        ;
+}
+
+/**
+ * Detect idle loops and skip their iterations up to the next event.
+ *
+ * The start of a loop is recognized by a backward jump. If it is reached
+ * again with the same registers and flags, without writes, without
+ * volatile reads and without stalls, every iteration will be
+ * identical until an event changes something, as nothing else
+ * can affect the CPU. The exit can then only be an interrupt or a change
+ * in memory, which both come from events, so whole iterations are
+ * skipped by advancing time, keeping the cycle accounting exact.
+ * This is called before fetching the opcode, so the fetch is performed
+ * at the new time.
+ *
+ * Besides loops like the JMP * of the PSID driver waiting for interrupts,
+ * this covers polling loops like BIT $D012/BNE or LDA $DC0D/BEQ:
+ * reads report how long their value holds, see stableRead, and the
+ * iterations are only skipped up to the first change. A read which may
+ * change at any time, like a running timer's low byte, makes the loop
+ * not idle. Nothing is skipped while the instructions are observed.
+ */
+void MOS6510::checkIdleLoop()
+{
+    const uint_least16_t pc = Register_ProgramCounter;
+    const bool backward = pc <= lastInstrPC;
+    lastInstrPC = pc;
+
+    if (pc == idleLoopPC)
+    {
+        const uint_least64_t state = idleState();
+        const event_clock_t now = eventContext.getTime(EVENT_CLOCK_PHI2);
+
+        if (!idleLoopDirty
+            && !observed()
+            && rdy
+            && state == idleLoopState
+            && !rstFlag && !nmiFlag && !(!flags.I && irqAssertedOnPin))
+        {
+            const event_clock_t iteration = now - idleLoopTime;
+            event_clock_t free = eventContext.freeCycles();
+            if (idleLoopStable >= 0 && idleLoopStable - now < free)
+                free = idleLoopStable - now;
+            const event_clock_t skip = (free / iteration) * iteration;
+            if (skip > 0)
+            {
+                eventContext.advance(static_cast<unsigned int>(skip));
+                idleLoopTime = now + skip;
+                idleLoopStable = -1;
+                return;
+            }
+        }
+
+        idleLoopTime = now;
+        idleLoopState = state;
+        idleLoopDirty = false;
+        idleLoopStable = -1;
+    }
+    else if (backward)
+    {
+        idleLoopPC = pc;
+        idleLoopTime = eventContext.getTime(EVENT_CLOCK_PHI2);
+        idleLoopState = idleState();
+        idleLoopDirty = false;
+        idleLoopStable = -1;
+    }
+}
+
+/**
+ * Describe the state after the current instruction.
+ */
+void MOS6510::traceRecord(CpuTraceRecord &record, event_clock_t time, uint8_t type)
+{
+    record.time = static_cast<uint32_t>(time);
+    record.pc = instrStartPC;
+    record.operand = instrOperand;
+    record.address = Cycle_EffectiveAddress;
+    record.opcode = instrOpcode;
+    record.data = Cycle_Data;
+    record.a = Register_Accumulator;
+    record.x = Register_X;
+    record.y = Register_Y;
+    record.sp = Register_StackPointer;
+    record.status = flags.get();
+    record.ddr = cpuPortDir();
+    record.pr = cpuPortData();
+    record.flags = type | (irqAssertedOnPin ? CpuTraceRecord::IRQ_ASSERTED : 0);
+}
+
+void MOS6510::traceInstruction(uint8_t type)
+{
+    CpuTraceRecord record;
+    traceRecord(record, eventContext.getTime(EVENT_CLOCK_PHI2), type);
+    m_cpuTrace->push(record);
+}
+
 void MOS6510::fetchNextOpcode()
 {
+    checkIdleLoop();
+
 #ifdef DEBUG
     if (dodump)
     {
         MOS6510Debug::DumpState(eventContext.getTime(EVENT_CLOCK_PHI2), *this);
     }
+#endif
+
+    if (m_cpuTrace != nullptr)
+        traceInstruction(0);
 
     instrStartPC = Register_ProgramCounter;
-#endif
 
-    cycleCount = cpuRead(Register_ProgramCounter) << 3;
+    instrOpcode = cpuRead(Register_ProgramCounter);
+    cycleCount = instrOpcode << 3;
+
+    if (m_trace != nullptr)
+        m_trace->instruction(Register_ProgramCounter, cycleCount >> 3);
+    if (m_profiler != nullptr)
+        m_profiler->instruction(Register_ProgramCounter, cycleCount >> 3, Register_StackPointer);
+    if (m_watchpoints != nullptr)
+        m_watchpoints->check(Register_ProgramCounter, instrOpcode, WATCH_EXECUTE);
+
     Register_ProgramCounter++;
 
     if (!rstFlag && !nmiFlag && !(!flags.I && irqAssertedOnPin))
@@ -334,9 +755,7 @@ void MOS6510::FetchDataByte()
         Register_ProgramCounter++;
     }
 
-#ifdef DEBUG
     instrOperand = Cycle_Data;
-#endif
 }
 
 /**
@@ -355,9 +774,7 @@ void MOS6510::FetchLowAddr()
     Cycle_EffectiveAddress = cpuRead(Register_ProgramCounter);
     Register_ProgramCounter++;
 
-#ifdef DEBUG
     instrOperand = Cycle_EffectiveAddress;
-#endif
 }
 
 /**
@@ -397,9 +814,7 @@ void MOS6510::FetchHighAddr()
     endian_16hi8(Cycle_EffectiveAddress, cpuRead(Register_ProgramCounter));
     Register_ProgramCounter++;
 
-#ifdef DEBUG
     endian_16hi8(instrOperand, endian_16hi8(Cycle_EffectiveAddress));
-#endif
 }
 
 /**
@@ -462,9 +877,7 @@ void MOS6510::FetchLowPointer()
     Cycle_Pointer = cpuRead(Register_ProgramCounter);
     Register_ProgramCounter++;
 
-#ifdef DEBUG
     instrOperand = Cycle_Pointer;
-#endif
 }
 
 /**
@@ -489,9 +902,7 @@ void MOS6510::FetchHighPointer()
     endian_16hi8(Cycle_Pointer, cpuRead(Register_ProgramCounter));
     Register_ProgramCounter++;
 
-#ifdef DEBUG
     endian_16hi8(instrOperand, endian_16hi8(Cycle_Pointer));
-#endif
 }
 
 /**
@@ -725,6 +1136,10 @@ void MOS6510::rti_instr()
         fprintf (m_fdbg, "****************************************************\n\n");
 #endif
     Register_ProgramCounter = Cycle_EffectiveAddress;
+
+    if (m_playTime != nullptr)
+        m_playTime->rti(Register_StackPointer);
+
     interruptsAndNextOpcode();
 }
 
@@ -1279,6 +1694,9 @@ void MOS6510::tya_instr()
 
 void MOS6510::illegal_instr()
 {
+    if (m_cpuTrace != nullptr)
+        traceInstruction(CpuTraceRecord::JAM);
+
     cycleCount --;
 }
 
@@ -1465,14 +1883,24 @@ void MOS6510::rra_instr()
  * @param context
  *            The Event Context
  */
-MOS6510::MOS6510(EventContext *context) :
+MOS6510::MOS6510(cpu_event_context_t *context) :
     eventContext(*context),
+    m_trace(nullptr),
+    m_profiler(nullptr),
+    m_playTime(nullptr),
+    m_cpuTrace(nullptr),
+    m_watchpoints(nullptr),
 #ifdef DEBUG
     m_fdbg(stdout),
 #endif
     m_nosteal("CPU-nosteal", *this, &MOS6510::eventWithoutSteals),
     m_steal("CPU-steal", *this, &MOS6510::eventWithSteals)
 {
+#ifdef CPU_SWITCH_DISPATCH
+    // Build the table of handlers first and convert it at the end
+    std::vector<ProcessorCycle> instrTable(0x101 << 3);
+#endif
+
     //----------------------------------------------------------------------
     // Build up the processor instruction table
     for (int i = 0; i < 0x100; i++)
@@ -2111,6 +2539,10 @@ MOS6510::MOS6510(EventContext *context) :
 #endif
     }
 
+#ifdef CPU_SWITCH_DISPATCH
+    buildMicroOpTable(&instrTable.front());
+#endif
+
     // Intialise Processor Registers
     Register_Accumulator   = 0;
     Register_X             = 0;
@@ -2141,6 +2573,11 @@ void MOS6510::Initialise()
     // Set PC to some value
     Register_ProgramCounter = 0;
 
+    // No instruction executed yet
+    instrStartPC = 0;
+    instrOpcode = 0;
+    instrOperand = 0;
+
     // IRQs pending check
     irqAssertedOnPin = false;
     nmiFlag = false;
@@ -2149,6 +2586,16 @@ void MOS6510::Initialise()
 
     // Signals
     rdy = true;
+    stalled = false;
+    stalledInterruptClock = -1;
+
+    // No loop to check
+    idleLoopPC = -1;
+    lastInstrPC = 0;
+    idleLoopTime = 0;
+    idleLoopState = 0;
+    idleLoopDirty = true;
+    idleLoopStable = -1;
 
     eventContext.schedule(m_nosteal, 0, EVENT_CLOCK_PHI2);
 }
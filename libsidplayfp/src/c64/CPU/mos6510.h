@@ -28,13 +28,15 @@
 
 #include "flags.h"
 #include "EventScheduler.h"
+#include "cpuprofiler.h"
+#include "playtime.h"
+#include "cputracebuffer.h"
+#include "c64/watchpoints.h"
 
 #ifdef HAVE_CONFIG_H
 #  include "config.h"
 #endif
 
-class EventContext;
-
 namespace libsidplayfp
 {
 
@@ -84,7 +86,9 @@ public:
 private:
     struct ProcessorCycle
     {
-        void (MOS6510::*func)();
+        typedef void (MOS6510::*func_t)();
+
+        func_t func;
         bool nosteal;
         ProcessorCycle() :
             func(0),
@@ -93,7 +97,22 @@ private:
 
 private:
     /// Our event context copy. */
-    EventContext &eventContext;
+    cpu_event_context_t &eventContext;
+
+    /// Tracing sink, null if tracing is disabled
+    ChromeTrace *m_trace;
+
+    /// Profiler, null if profiling is disabled
+    CpuProfiler *m_profiler;
+
+    /// Play call meter, null if disabled
+    PlayTime *m_playTime;
+
+    /// Binary instruction trace, null if disabled
+    CpuTraceBuffer *m_cpuTrace;
+
+    /// Watched executions, null if none
+    Watchpoints *m_watchpoints;
 
     /// Current instruction and subcycle within instruction
     int cycleCount;
@@ -113,6 +132,12 @@ private:
     /// RDY pin state (stop CPU on read)
     bool rdy;
 
+    /// The CPU is parked on a read cycle until RDY goes high
+    bool stalled;
+
+    /// PHI2 clock of the interrupt delay processed while parked, -1 if none
+    event_clock_t stalledInterruptClock;
+
     /// Status register
     Flags flags;
 
@@ -128,18 +153,44 @@ private:
     uint8_t Register_X;
     uint8_t Register_Y;
 
-#ifdef DEBUG
-    // Debug info
+    /// Start of the loop being checked for idleness, -1 if none
+    int idleLoopPC;
+
+    /// Address of the last fetched instruction
+    uint_least16_t lastInstrPC;
+
+    /// Time the loop start was last reached
+    event_clock_t idleLoopTime;
+
+    /// Registers and flags when the loop start was last reached
+    uint_least64_t idleLoopState;
+
+    /// The loop has done something that may not be repeated identically
+    bool idleLoopDirty;
+
+    /// Last time the values read by the loop are known to hold, -1 if none was read
+    event_clock_t idleLoopStable;
+
+    /// Address, opcode and operand of the current instruction
+    //@{
     uint_least16_t instrStartPC;
+    uint8_t instrOpcode;
     uint_least16_t instrOperand;
+    //@}
 
+#ifdef DEBUG
     FILE *m_fdbg;
 
     bool dodump;
 #endif
 
+#ifdef CPU_SWITCH_DISPATCH
+    /// Table of CPU opcode implementations as micro-op ids
+    uint8_t microOpTable[0x101 << 3];
+#else
     /// Table of CPU opcode implementations
     struct ProcessorCycle instrTable[0x101 << 3];
+#endif
 
 private:
     /// Represents an instruction subcycle that writes
@@ -151,6 +202,21 @@ private:
     void eventWithoutSteals();
     void eventWithSteals();
 
+    inline void executeCycle();
+    inline bool noStealCycle() const;
+
+    inline uint_least64_t idleState();
+    inline bool observed() const;
+    inline void checkIdleLoop();
+
+    void traceRecord(CpuTraceRecord &record, event_clock_t time, uint8_t type);
+    void traceInstruction(uint8_t type);
+
+#ifdef CPU_SWITCH_DISPATCH
+    inline void dispatch(uint8_t microOp);
+    void buildMicroOpTable(const ProcessorCycle *instrTable);
+#endif
+
     void Initialise();
 
     // Declare Interrupt Routines
@@ -158,6 +224,7 @@ private:
     inline void IRQHiRequest();
     inline void interruptsAndNextOpcode();
     inline void calculateInterruptTriggerCycle();
+    void stalledInterruptDelay();
 
     // Declare Instruction Routines
     inline void fetchNextOpcode();
@@ -278,9 +345,45 @@ private:
     inline void doJSR();
 
 protected:
-    MOS6510(EventContext *context);
+    MOS6510(cpu_event_context_t *context);
     ~MOS6510() {}
 
+    /**
+     * Signal a memory access which has side effects or
+     * whose result may change over time, so that the loop
+     * being executed is not considered idle.
+     */
+    void volatileAccess() { idleLoopDirty = true; }
+
+    /**
+     * Signal a read whose result stays the same for the given
+     * number of cycles if no event fires, so that the loop being
+     * executed is only skipped as long as the value doesn't change.
+     * As any event may change it, the value is assumed to hold at
+     * most until the first event due when the read started.
+     * The C64 signals the reads of the processor port and of the
+     * I/O area, which allows to skip loops polling the VIC or the CIAs.
+     *
+     * @param cycles the number of cycles, 0 if the value may change at any time,
+     *               UINT_MAX if it only changes in events
+     * @param free the free cycles before the read, see CpuEventContext::freeCycles
+     */
+    void stableRead(unsigned int cycles, event_clock_t free)
+    {
+        if (cycles == 0)
+        {
+            idleLoopDirty = true;
+        }
+        else
+        {
+            if (cycles < free)
+                free = cycles;
+            const event_clock_t until = eventContext.getTime(EVENT_CLOCK_PHI2) + free;
+            if (idleLoopStable < 0 || until < idleLoopStable)
+                idleLoopStable = until;
+        }
+    }
+
 public:
     /**
      * Get data from system environment.
@@ -298,6 +401,15 @@ public:
      */
     virtual void cpuWrite(uint_least16_t addr, uint8_t data) =0;
 
+    /**
+     * Get the processor port registers from system environment,
+     * without the side effects of a memory access.
+     */
+    //@{
+    virtual uint8_t cpuPortDir() const =0;
+    virtual uint8_t cpuPortData() const =0;
+    //@}
+
 #ifdef PC64_TESTSUITE
     virtual void loadFile(const char *file) =0;
 #endif
@@ -307,6 +419,47 @@ public:
     static const char *credits() { return credit; }
 
     void debug(bool enable, FILE *out);
+
+    /**
+     * Set the tracing sink for instruction boundaries.
+     *
+     * @param trace the sink, null to disable tracing
+     */
+    void setTrace(ChromeTrace *trace) { m_trace = trace; }
+
+    /**
+     * Set the profiler of the executed code.
+     *
+     * @param profiler the profiler, null to disable profiling
+     */
+    void setProfiler(CpuProfiler *profiler) { m_profiler = profiler; }
+
+    /**
+     * Set the meter of the interrupt driven play calls.
+     *
+     * @param playTime the meter, null to disable it
+     */
+    void setPlayTime(PlayTime *playTime) { m_playTime = playTime; }
+
+    /**
+     * Set the buffer of the binary instruction trace.
+     *
+     * @param cpuTrace the buffer, null to disable tracing
+     */
+    void setCpuTrace(CpuTraceBuffer *cpuTrace) { m_cpuTrace = cpuTrace; }
+
+    /**
+     * Set the watched executions.
+     *
+     * @param watchpoints the watchpoints, null if no execution is watched
+     */
+    void setWatchpoints(Watchpoints *watchpoints) { m_watchpoints = watchpoints; }
+
+    /**
+     * Get the address of the instruction being executed.
+     */
+    uint_least16_t getInstructionPC() const { return instrStartPC; }
+
     void setRDY(bool newRDY);
 
     // Non-standard functions
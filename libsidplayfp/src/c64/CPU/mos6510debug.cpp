@@ -22,48 +22,43 @@
 
 #include "mos6510debug.h"
 
-#ifdef DEBUG
-
-#include <cstdio>
 #include <cstdlib>
 
-#include "mos6510.h"
 #include "sidendian.h"
 #include "opcodes.h"
 
+#ifdef DEBUG
+#  include "mos6510.h"
+#endif
+
 namespace libsidplayfp
 {
 
-void MOS6510Debug::DumpState (event_clock_t time, MOS6510 &cpu)
+void MOS6510Debug::DumpRecord(FILE *out, const CpuTraceRecord &record)
 {
-    fprintf(cpu.m_fdbg, " PC  I  A  X  Y  SP  DR PR NV-BDIZC  Instruction (%d)\n", static_cast<int>(time));
-    fprintf(cpu.m_fdbg, "%04x ",   cpu.instrStartPC);
-    fprintf(cpu.m_fdbg, cpu.irqAssertedOnPin ? "t " : "f ");
-    fprintf(cpu.m_fdbg, "%02x ",   cpu.Register_Accumulator);
-    fprintf(cpu.m_fdbg, "%02x ",   cpu.Register_X);
-    fprintf(cpu.m_fdbg, "%02x ",   cpu.Register_Y);
-    fprintf(cpu.m_fdbg, "01%02x ", endian_16lo8 (cpu.Register_StackPointer));
-    fprintf(cpu.m_fdbg, "%02x ",   cpu.cpuRead (0));
-    fprintf(cpu.m_fdbg, "%02x ",   cpu.cpuRead (1));
+    fprintf(out, " PC  I  A  X  Y  SP  DR PR NV-BDIZC  Instruction (%d)\n", static_cast<int>(record.time));
+    fprintf(out, "%04x ",   record.pc);
+    fprintf(out, (record.flags & CpuTraceRecord::IRQ_ASSERTED) ? "t " : "f ");
+    fprintf(out, "%02x ",   record.a);
+    fprintf(out, "%02x ",   record.x);
+    fprintf(out, "%02x ",   record.y);
+    fprintf(out, "01%02x ", record.sp);
+    fprintf(out, "%02x ",   record.ddr);
+    fprintf(out, "%02x ",   record.pr);
 
-    fprintf(cpu.m_fdbg, cpu.flags.N ? "1" : "0");
-    fprintf(cpu.m_fdbg, cpu.flags.V ? "1" : "0");
-    fprintf(cpu.m_fdbg, "1");
-    fprintf(cpu.m_fdbg, cpu.flags.B ? "1" : "0");
-    fprintf(cpu.m_fdbg, cpu.flags.D ? "1" : "0");
-    fprintf(cpu.m_fdbg, cpu.flags.I ? "1" : "0");
-    fprintf(cpu.m_fdbg, cpu.flags.Z ? "1" : "0");
-    fprintf(cpu.m_fdbg, cpu.flags.C ? "1" : "0");
+    // NV-BDIZC, the unused bit always reads as 1
+    for (int bit = 7; bit >= 0; bit--)
+        fprintf(out, (record.status & (1 << bit)) ? "1" : "0");
 
-    const int opcode  = cpu.cpuRead(cpu.instrStartPC);
+    const int opcode = record.opcode;
 
-    fprintf(cpu.m_fdbg, "  %02x ", opcode);
+    fprintf(out, "  %02x ", opcode);
 
     switch(opcode)
     {
-    //Accumulator or Implied cpu.Cycle_EffectiveAddressing
+    //Accumulator or Implied Addressing Mode Handler
     case ASLn: case LSRn: case ROLn: case RORn:
-        fprintf(cpu.m_fdbg, "      ");
+        fprintf(out, "      ");
     break;
     //Zero Page Addressing Mode Handler
     case ADCz: case ANDz: case ASLz: case BITz: case CMPz: case CPXz:
@@ -72,7 +67,7 @@ void MOS6510Debug::DumpState (event_clock_t time, MOS6510 &cpu)
     case ORAz: case ROLz: case RORz: case SAXz: case SBCz: case SREz:
     case STAz: case STXz: case STYz: case SLOz: case RLAz: case RRAz:
     //ASOz AXSz DCMz INSz LSEz - Optional Opcode Names
-        fprintf(cpu.m_fdbg, "%02x    ", endian_16lo8 (cpu.instrOperand));
+        fprintf(out, "%02x    ", endian_16lo8 (record.operand));
         break;
     //Zero Page with X Offset Addressing Mode Handler
     case ADCzx:  case ANDzx: case ASLzx: case CMPzx: case DCPzx: case DECzx:
@@ -80,12 +75,12 @@ void MOS6510Debug::DumpState (event_clock_t time, MOS6510 &cpu)
     case NOPzx_: case ORAzx: case RLAzx: case ROLzx: case RORzx: case RRAzx:
     case SBCzx:  case SLOzx: case SREzx: case STAzx: case STYzx:
     //ASOzx DCMzx INSzx LSEzx - Optional Opcode Names
-        fprintf(cpu.m_fdbg, "%02x    ", endian_16lo8 (cpu.instrOperand));
+        fprintf(out, "%02x    ", endian_16lo8 (record.operand));
         break;
     //Zero Page with Y Offset Addressing Mode Handler
     case LDXzy: case STXzy: case SAXzy: case LAXzy:
     //AXSzx - Optional Opcode Names
-        fprintf(cpu.m_fdbg, "%02x    ", endian_16lo8 (cpu.instrOperand));
+        fprintf(out, "%02x    ", endian_16lo8 (record.operand));
         break;
     //Absolute Addressing Mode Handler
     case ADCa: case ANDa: case ASLa: case BITa: case CMPa: case CPXa:
@@ -95,7 +90,7 @@ void MOS6510Debug::DumpState (event_clock_t time, MOS6510 &cpu)
     case SBCa: case SLOa: case SREa: case STAa: case STXa: case STYa:
     case RLAa: case RRAa:
     //ASOa AXSa DCMa INSa LSEa - Optional Opcode Names
-        fprintf(cpu.m_fdbg, "%02x %02x ", endian_16lo8 (cpu.instrOperand), endian_16hi8 (cpu.instrOperand));
+        fprintf(out, "%02x %02x ", endian_16lo8 (record.operand), endian_16hi8 (record.operand));
         break;
     //Absolute With X Offset Addresing Mode Handler
     case ADCax:  case ANDax: case ASLax: case CMPax: case DCPax: case DECax:
@@ -103,7 +98,7 @@ void MOS6510Debug::DumpState (event_clock_t time, MOS6510 &cpu)
     case NOPax_: case ORAax: case RLAax: case ROLax: case RORax: case RRAax:
     case SBCax:  case SHYax: case SLOax: case SREax: case STAax:
     //ASOax DCMax INSax LSEax SAYax - Optional Opcode Names
-        fprintf(cpu.m_fdbg, "%02x %02x ", endian_16lo8 (cpu.instrOperand), endian_16hi8 (cpu.instrOperand));
+        fprintf(out, "%02x %02x ", endian_16lo8 (record.operand), endian_16hi8 (record.operand));
         break;
     //Absolute With Y Offset Addresing Mode Handler
     case ADCay: case ANDay: case CMPay: case DCPay: case EORay: case ISBay:
@@ -111,7 +106,7 @@ void MOS6510Debug::DumpState (event_clock_t time, MOS6510 &cpu)
     case RRAay: case SBCay: case SHAay: case SHSay: case SHXay: case SLOay:
     case SREay: case STAay:
     //ASOay AXAay DCMay INSax LSEay TASay XASay - Optional Opcode Names
-        fprintf(cpu.m_fdbg, "%02x %02x ", endian_16lo8 (cpu.instrOperand), endian_16hi8 (cpu.instrOperand));
+        fprintf(out, "%02x %02x ", endian_16lo8 (record.operand), endian_16hi8 (record.operand));
         break;
     //Immediate and Relative Addressing Mode Handler
     case ADCb: case ANDb: case ANCb_: case ANEb: case ASRb:  case ARRb:
@@ -120,28 +115,28 @@ void MOS6510Debug::DumpState (event_clock_t time, MOS6510 &cpu)
     case CMPb: case CPXb: case CPYb:  case EORb: case LDAb:  case LDXb:
     case LDYb: case LXAb: case NOPb_: case ORAb: case SBCb_: case SBXb:
     //OALb ALRb XAAb - Optional Opcode Names
-        fprintf(cpu.m_fdbg, "%02x    ", endian_16lo8 (cpu.Cycle_Data));
+        fprintf(out, "%02x    ", endian_16lo8 (record.data));
         break;
     //Indirect Addressing Mode Handler
     case JMPi:
-        fprintf(cpu.m_fdbg, "%02x %02x ", endian_16lo8 (cpu.instrOperand), endian_16hi8 (cpu.instrOperand));
+        fprintf(out, "%02x %02x ", endian_16lo8 (record.operand), endian_16hi8 (record.operand));
         break;
     //Indexed with X Preinc Addressing Mode Handler
     case ADCix: case ANDix: case CMPix: case DCPix: case EORix: case ISBix:
     case LAXix: case LDAix: case ORAix: case SAXix: case SBCix: case SLOix:
     case SREix: case STAix: case RLAix: case RRAix:
     //ASOix AXSix DCMix INSix LSEix - Optional Opcode Names
-        fprintf(cpu.m_fdbg, "%02x    ", endian_16lo8 (cpu.instrOperand));
+        fprintf(out, "%02x    ", endian_16lo8 (record.operand));
         break;
     //Indexed with Y Postinc Addressing Mode Handler
     case ADCiy: case ANDiy: case CMPiy: case DCPiy: case EORiy: case ISBiy:
     case LAXiy: case LDAiy: case ORAiy: case RLAiy: case RRAiy: case SBCiy:
     case SHAiy: case SLOiy: case SREiy: case STAiy:
     //AXAiy ASOiy LSEiy DCMiy INSiy - Optional Opcode Names
-        fprintf(cpu.m_fdbg, "%02x    ", endian_16lo8 (cpu.instrOperand));
+        fprintf(out, "%02x    ", endian_16lo8 (record.operand));
         break;
     default:
-        fprintf(cpu.m_fdbg, "      ");
+        fprintf(out, "      ");
         break;
     }
 
@@ -149,183 +144,183 @@ void MOS6510Debug::DumpState (event_clock_t time, MOS6510 &cpu)
     {
     case ADCb: case ADCz: case ADCzx: case ADCa: case ADCax: case ADCay:
     case ADCix: case ADCiy:
-        fprintf(cpu.m_fdbg, " ADC"); break;
+        fprintf(out, " ADC"); break;
     case ANCb_:
-        fprintf(cpu.m_fdbg, "*ANC"); break;
+        fprintf(out, "*ANC"); break;
     case ANDb: case ANDz: case ANDzx: case ANDa: case ANDax: case ANDay:
     case ANDix: case ANDiy:
-        fprintf(cpu.m_fdbg, " AND"); break;
+        fprintf(out, " AND"); break;
     case ANEb: //Also known as XAA
-        fprintf(cpu.m_fdbg, "*ANE"); break;
+        fprintf(out, "*ANE"); break;
     case ARRb:
-        fprintf(cpu.m_fdbg, "*ARR"); break;
+        fprintf(out, "*ARR"); break;
     case ASLn: case ASLz: case ASLzx: case ASLa: case ASLax:
-        fprintf(cpu.m_fdbg, " ASL"); break;
+        fprintf(out, " ASL"); break;
     case ASRb: //Also known as ALR
-        fprintf(cpu.m_fdbg, "*ASR"); break;
+        fprintf(out, "*ASR"); break;
     case BCCr:
-        fprintf(cpu.m_fdbg, " BCC"); break;
+        fprintf(out, " BCC"); break;
     case BCSr:
-        fprintf(cpu.m_fdbg, " BCS"); break;
+        fprintf(out, " BCS"); break;
     case BEQr:
-        fprintf(cpu.m_fdbg, " BEQ"); break;
+        fprintf(out, " BEQ"); break;
     case BITz: case BITa:
-        fprintf(cpu.m_fdbg, " BIT"); break;
+        fprintf(out, " BIT"); break;
     case BMIr:
-        fprintf(cpu.m_fdbg, " BMI"); break;
+        fprintf(out, " BMI"); break;
     case BNEr:
-        fprintf(cpu.m_fdbg, " BNE"); break;
+        fprintf(out, " BNE"); break;
     case BPLr:
-        fprintf(cpu.m_fdbg, " BPL"); break;
+        fprintf(out, " BPL"); break;
     case BRKn:
-        fprintf(cpu.m_fdbg, " BRK"); break;
+        fprintf(out, " BRK"); break;
     case BVCr:
-        fprintf(cpu.m_fdbg, " BVC"); break;
+        fprintf(out, " BVC"); break;
     case BVSr:
-        fprintf(cpu.m_fdbg, " BVS"); break;
+        fprintf(out, " BVS"); break;
     case CLCn:
-        fprintf(cpu.m_fdbg, " CLC"); break;
+        fprintf(out, " CLC"); break;
     case CLDn:
-        fprintf(cpu.m_fdbg, " CLD"); break;
+        fprintf(out, " CLD"); break;
     case CLIn:
-        fprintf(cpu.m_fdbg, " CLI"); break;
+        fprintf(out, " CLI"); break;
     case CLVn:
-        fprintf(cpu.m_fdbg, " CLV"); break;
+        fprintf(out, " CLV"); break;
     case CMPb: case CMPz: case CMPzx: case CMPa: case CMPax: case CMPay:
     case CMPix: case CMPiy:
-        fprintf(cpu.m_fdbg, " CMP"); break;
+        fprintf(out, " CMP"); break;
     case CPXb: case CPXz: case CPXa:
-        fprintf(cpu.m_fdbg, " CPX"); break;
+        fprintf(out, " CPX"); break;
     case CPYb: case CPYz: case CPYa:
-        fprintf(cpu.m_fdbg, " CPY"); break;
+        fprintf(out, " CPY"); break;
     case DCPz: case DCPzx: case DCPa: case DCPax: case DCPay: case DCPix:
     case DCPiy: //Also known as DCM
-        fprintf(cpu.m_fdbg, "*DCP"); break;
+        fprintf(out, "*DCP"); break;
     case DECz: case DECzx: case DECa: case DECax:
-        fprintf(cpu.m_fdbg, " DEC"); break;
+        fprintf(out, " DEC"); break;
     case DEXn:
-        fprintf(cpu.m_fdbg, " DEX"); break;
+        fprintf(out, " DEX"); break;
     case DEYn:
-        fprintf(cpu.m_fdbg, " DEY"); break;
+        fprintf(out, " DEY"); break;
     case EORb: case EORz: case EORzx: case EORa: case EORax: case EORay:
     case EORix: case EORiy:
-        fprintf(cpu.m_fdbg, " EOR"); break;
+        fprintf(out, " EOR"); break;
     case INCz: case INCzx: case INCa: case INCax:
-        fprintf(cpu.m_fdbg, " INC"); break;
+        fprintf(out, " INC"); break;
     case INXn:
-        fprintf(cpu.m_fdbg, " INX"); break;
+        fprintf(out, " INX"); break;
     case INYn:
-        fprintf(cpu.m_fdbg, " INY"); break;
+        fprintf(out, " INY"); break;
     case ISBz: case ISBzx: case ISBa: case ISBax: case ISBay: case ISBix:
     case ISBiy: //Also known as INS
-        fprintf(cpu.m_fdbg, "*ISB"); break;
+        fprintf(out, "*ISB"); break;
     case JMPw: case JMPi:
-        fprintf(cpu.m_fdbg, " JMP"); break;
+        fprintf(out, " JMP"); break;
     case JSRw:
-        fprintf(cpu.m_fdbg, " JSR"); break;
+        fprintf(out, " JSR"); break;
     case LASay:
-        fprintf(cpu.m_fdbg, "*LAS"); break;
+        fprintf(out, "*LAS"); break;
     case LAXz: case LAXzy: case LAXa: case LAXay: case LAXix: case LAXiy:
-        fprintf(cpu.m_fdbg, "*LAX"); break;
+        fprintf(out, "*LAX"); break;
     case LDAb: case LDAz: case LDAzx: case LDAa: case LDAax: case LDAay:
     case LDAix: case LDAiy:
-        fprintf(cpu.m_fdbg, " LDA"); break;
+        fprintf(out, " LDA"); break;
     case LDXb: case LDXz: case LDXzy: case LDXa: case LDXay:
-        fprintf(cpu.m_fdbg, " LDX"); break;
+        fprintf(out, " LDX"); break;
     case LDYb: case LDYz: case LDYzx: case LDYa: case LDYax:
-        fprintf(cpu.m_fdbg, " LDY"); break;
+        fprintf(out, " LDY"); break;
     case LSRz: case LSRzx: case LSRa: case LSRax: case LSRn:
-        fprintf(cpu.m_fdbg, " LSR"); break;
+        fprintf(out, " LSR"); break;
     case NOPn_: case NOPb_: case NOPz_: case NOPzx_: case NOPa: case NOPax_:
-        if(opcode != NOPn) fprintf(cpu.m_fdbg, "*");
-        else fprintf(cpu.m_fdbg, " ");
-        fprintf(cpu.m_fdbg, "NOP"); break;
+        if(opcode != NOPn) fprintf(out, "*");
+        else fprintf(out, " ");
+        fprintf(out, "NOP"); break;
     case LXAb: //Also known as OAL
-        fprintf(cpu.m_fdbg, "*LXA"); break;
+        fprintf(out, "*LXA"); break;
     case ORAb: case ORAz: case ORAzx: case ORAa: case ORAax: case ORAay:
     case ORAix: case ORAiy:
-        fprintf(cpu.m_fdbg, " ORA"); break;
+        fprintf(out, " ORA"); break;
     case PHAn:
-        fprintf(cpu.m_fdbg, " PHA"); break;
+        fprintf(out, " PHA"); break;
     case PHPn:
-        fprintf(cpu.m_fdbg, " PHP"); break;
+        fprintf(out, " PHP"); break;
     case PLAn:
-        fprintf(cpu.m_fdbg, " PLA"); break;
+        fprintf(out, " PLA"); break;
     case PLPn:
-        fprintf(cpu.m_fdbg, " PLP"); break;
+        fprintf(out, " PLP"); break;
     case RLAz: case RLAzx: case RLAix: case RLAa: case RLAax: case RLAay:
     case RLAiy:
-        fprintf(cpu.m_fdbg, "*RLA"); break;
+        fprintf(out, "*RLA"); break;
     case ROLz: case ROLzx: case ROLa: case ROLax: case ROLn:
-        fprintf(cpu.m_fdbg, " ROL"); break;
+        fprintf(out, " ROL"); break;
     case RORz: case RORzx: case RORa: case RORax: case RORn:
-        fprintf(cpu.m_fdbg, " ROR"); break;
+        fprintf(out, " ROR"); break;
     case RRAa: case RRAax: case RRAay: case RRAz: case RRAzx: case RRAix:
     case RRAiy:
-        fprintf(cpu.m_fdbg, "*RRA"); break;
+        fprintf(out, "*RRA"); break;
     case RTIn:
-        fprintf(cpu.m_fdbg, " RTI"); break;
+        fprintf(out, " RTI"); break;
     case RTSn:
-        fprintf(cpu.m_fdbg, " RTS"); break;
+        fprintf(out, " RTS"); break;
     case SAXz: case SAXzy: case SAXa: case SAXix: //Also known as AXS
-        fprintf(cpu.m_fdbg, "*SAX"); break;
+        fprintf(out, "*SAX"); break;
     case SBCb_:
-        if(opcode != SBCb) fprintf(cpu.m_fdbg, "*");
-        else fprintf(cpu.m_fdbg, " ");
-        fprintf(cpu.m_fdbg, "SBC"); break;
+        if(opcode != SBCb) fprintf(out, "*");
+        else fprintf(out, " ");
+        fprintf(out, "SBC"); break;
     case SBCz: case SBCzx: case SBCa: case SBCax: case SBCay: case SBCix:
     case SBCiy:
-        fprintf(cpu.m_fdbg, " SBC"); break;
+        fprintf(out, " SBC"); break;
     case SBXb:
-        fprintf(cpu.m_fdbg, "*SBX"); break;
+        fprintf(out, "*SBX"); break;
     case SECn:
-        fprintf(cpu.m_fdbg, " SEC"); break;
+        fprintf(out, " SEC"); break;
     case SEDn:
-        fprintf(cpu.m_fdbg, " SED"); break;
+        fprintf(out, " SED"); break;
     case SEIn:
-        fprintf(cpu.m_fdbg, " SEI"); break;
+        fprintf(out, " SEI"); break;
     case SHAay: case SHAiy: //Also known as AXA
-        fprintf(cpu.m_fdbg, "*SHA"); break;
+        fprintf(out, "*SHA"); break;
     case SHSay: //Also known as TAS
-        fprintf(cpu.m_fdbg, "*SHS"); break;
+        fprintf(out, "*SHS"); break;
     case SHXay: //Also known as XAS
-        fprintf(cpu.m_fdbg, "*SHX"); break;
+        fprintf(out, "*SHX"); break;
     case SHYax: //Also known as SAY
-        fprintf(cpu.m_fdbg, "*SHY"); break;
+        fprintf(out, "*SHY"); break;
     case SLOz: case SLOzx: case SLOa: case SLOax: case SLOay: case SLOix:
     case SLOiy: //Also known as ASO
-        fprintf(cpu.m_fdbg, "*SLO"); break;
+        fprintf(out, "*SLO"); break;
     case SREz: case SREzx: case SREa: case SREax: case SREay: case SREix:
     case SREiy: //Also known as LSE
-        fprintf(cpu.m_fdbg, "*SRE"); break;
+        fprintf(out, "*SRE"); break;
     case STAz: case STAzx: case STAa: case STAax: case STAay: case STAix:
     case STAiy:
-        fprintf(cpu.m_fdbg, " STA"); break;
+        fprintf(out, " STA"); break;
     case STXz: case STXzy: case STXa:
-        fprintf(cpu.m_fdbg, " STX"); break;
+        fprintf(out, " STX"); break;
     case STYz: case STYzx: case STYa:
-        fprintf(cpu.m_fdbg, " STY"); break;
+        fprintf(out, " STY"); break;
     case TAXn:
-        fprintf(cpu.m_fdbg, " TAX"); break;
+        fprintf(out, " TAX"); break;
     case TAYn:
-        fprintf(cpu.m_fdbg, " TAY"); break;
+        fprintf(out, " TAY"); break;
     case TSXn:
-        fprintf(cpu.m_fdbg, " TSX"); break;
+        fprintf(out, " TSX"); break;
     case TXAn:
-        fprintf(cpu.m_fdbg, " TXA"); break;
+        fprintf(out, " TXA"); break;
     case TXSn:
-        fprintf(cpu.m_fdbg, " TXS"); break;
+        fprintf(out, " TXS"); break;
     case TYAn:
-        fprintf(cpu.m_fdbg, " TYA"); break;
+        fprintf(out, " TYA"); break;
     default:
-        fprintf(cpu.m_fdbg, "*HLT"); break;
+        fprintf(out, "*HLT"); break;
     }
 
     switch(opcode)
     {
-    //Accumulator or Implied cpu.Cycle_EffectiveAddressing
+    //Accumulator or Implied Addressing Mode Handler
     case ASLn: case LSRn: case ROLn: case RORn:
-        fprintf(cpu.m_fdbg, "n  A");
+        fprintf(out, "n  A");
     break;
 
     //Zero Page Addressing Mode Handler
@@ -336,13 +331,11 @@ void MOS6510Debug::DumpState (event_clock_t time, MOS6510 &cpu)
     case ROLz: case RORz: case SBCz: case SREz: case SLOz: case RLAz:
     case RRAz:
     //ASOz AXSz DCMz INSz LSEz - Optional Opcode Names
-        fprintf(cpu.m_fdbg, "z  %02x {%02x}", endian_16lo8 (cpu.instrOperand), cpu.Cycle_Data);
+        fprintf(out, "z  %02x {%02x}", endian_16lo8 (record.operand), record.data);
     break;
     case SAXz: case STAz: case STXz: case STYz:
-#ifdef DEBUG
     case NOPz_:
-#endif
-        fprintf(cpu.m_fdbg, "z  %02x", endian_16lo8 (cpu.instrOperand));
+        fprintf(out, "z  %02x", endian_16lo8 (record.operand));
     break;
 
     //Zero Page with X Offset Addressing Mode Handler
@@ -351,26 +344,24 @@ void MOS6510Debug::DumpState (event_clock_t time, MOS6510 &cpu)
     case ORAzx: case RLAzx: case ROLzx: case RORzx: case RRAzx: case SBCzx:
     case SLOzx: case SREzx:
     //ASOzx DCMzx INSzx LSEzx - Optional Opcode Names
-        fprintf(cpu.m_fdbg, "zx %02x,X", endian_16lo8 (cpu.instrOperand));
-        fprintf(cpu.m_fdbg, " [%04x]{%02x}", cpu.Cycle_EffectiveAddress, cpu.Cycle_Data);
+        fprintf(out, "zx %02x,X", endian_16lo8 (record.operand));
+        fprintf(out, " [%04x]{%02x}", record.address, record.data);
     break;
     case STAzx: case STYzx:
-#ifdef DEBUG
     case NOPzx_:
-#endif
-        fprintf(cpu.m_fdbg, "zx %02x,X", endian_16lo8 (cpu.instrOperand));
-        fprintf(cpu.m_fdbg, " [%04x]", cpu.Cycle_EffectiveAddress);
+        fprintf(out, "zx %02x,X", endian_16lo8 (record.operand));
+        fprintf(out, " [%04x]", record.address);
     break;
 
     //Zero Page with Y Offset Addressing Mode Handler
     case LAXzy: case LDXzy:
     //AXSzx - Optional Opcode Names
-        fprintf(cpu.m_fdbg, "zy %02x,Y", endian_16lo8 (cpu.instrOperand));
-        fprintf(cpu.m_fdbg, " [%04x]{%02x}", cpu.Cycle_EffectiveAddress, cpu.Cycle_Data);
+        fprintf(out, "zy %02x,Y", endian_16lo8 (record.operand));
+        fprintf(out, " [%04x]{%02x}", record.address, record.data);
     break;
     case STXzy: case SAXzy:
-        fprintf(cpu.m_fdbg, "zy %02x,Y", endian_16lo8 (cpu.instrOperand));
-        fprintf(cpu.m_fdbg, " [%04x]", cpu.Cycle_EffectiveAddress);
+        fprintf(out, "zy %02x,Y", endian_16lo8 (record.operand));
+        fprintf(out, " [%04x]", record.address);
     break;
 
     //Absolute Addressing Mode Handler
@@ -380,16 +371,14 @@ void MOS6510Debug::DumpState (event_clock_t time, MOS6510 &cpu)
     case ROLa: case RORa: case SBCa: case SLOa: case SREa: case RLAa:
     case RRAa:
     //ASOa AXSa DCMa INSa LSEa - Optional Opcode Names
-        fprintf(cpu.m_fdbg, "a  %04x {%02x}", cpu.instrOperand, cpu.Cycle_Data);
+        fprintf(out, "a  %04x {%02x}", record.operand, record.data);
     break;
     case SAXa: case STAa: case STXa: case STYa:
-#ifdef DEBUG
     case NOPa:
-#endif
-        fprintf(cpu.m_fdbg, "a  %04x", cpu.instrOperand);
+        fprintf(out, "a  %04x", record.operand);
     break;
     case JMPw: case JSRw:
-        fprintf(cpu.m_fdbg, "w  %04x", cpu.instrOperand);
+        fprintf(out, "w  %04x", record.operand);
     break;
 
     //Absolute With X Offset Addresing Mode Handler
@@ -398,15 +387,13 @@ void MOS6510Debug::DumpState (event_clock_t time, MOS6510 &cpu)
     case ORAax: case RLAax: case ROLax: case RORax: case RRAax: case SBCax:
     case SLOax: case SREax:
     //ASOax DCMax INSax LSEax SAYax - Optional Opcode Names
-        fprintf(cpu.m_fdbg, "ax %04x,X", cpu.instrOperand);
-        fprintf(cpu.m_fdbg, " [%04x]{%02x}", cpu.Cycle_EffectiveAddress, cpu.Cycle_Data);
+        fprintf(out, "ax %04x,X", record.operand);
+        fprintf(out, " [%04x]{%02x}", record.address, record.data);
     break;
     case SHYax: case STAax:
-#ifdef DEBUG
     case NOPax_:
-#endif
-        fprintf(cpu.m_fdbg, "ax %04x,X", cpu.instrOperand);
-        fprintf(cpu.m_fdbg, " [%04x]", cpu.Cycle_EffectiveAddress);
+        fprintf(out, "ax %04x,X", record.operand);
+        fprintf(out, " [%04x]", record.address);
     break;
 
     //Absolute With Y Offset Addresing Mode Handler
@@ -414,12 +401,12 @@ void MOS6510Debug::DumpState (event_clock_t time, MOS6510 &cpu)
     case LASay: case LAXay: case LDAay: case LDXay: case ORAay: case RLAay:
     case RRAay: case SBCay: case SHSay: case SLOay: case SREay:
     //ASOay AXAay DCMay INSax LSEay TASay XASay - Optional Opcode Names
-        fprintf(cpu.m_fdbg, "ay %04x,Y", cpu.instrOperand);
-        fprintf(cpu.m_fdbg, " [%04x]{%02x}", cpu.Cycle_EffectiveAddress, cpu.Cycle_Data);
+        fprintf(out, "ay %04x,Y", record.operand);
+        fprintf(out, " [%04x]{%02x}", record.address, record.data);
     break;
     case SHAay: case SHXay: case STAay:
-        fprintf(cpu.m_fdbg, "ay %04x,Y", cpu.instrOperand);
-        fprintf(cpu.m_fdbg, " [%04x]", cpu.Cycle_EffectiveAddress);
+        fprintf(out, "ay %04x,Y", record.operand);
+        fprintf(out, " [%04x]", record.address);
     break;
 
     //Immediate Addressing Mode Handler
@@ -427,23 +414,21 @@ void MOS6510Debug::DumpState (event_clock_t time, MOS6510 &cpu)
     case CMPb: case CPXb: case CPYb:  case EORb: case LDAb:  case LDXb:
     case LDYb: case LXAb: case ORAb: case SBCb_: case SBXb:
     //OALb ALRb XAAb - Optional Opcode Names
-#ifdef DEBUG
     case NOPb_:
-#endif
-        fprintf(cpu.m_fdbg, "b  #%02x", endian_16lo8 (cpu.instrOperand));
+        fprintf(out, "b  #%02x", endian_16lo8 (record.operand));
     break;
 
     //Relative Addressing Mode Handler
     case BCCr: case BCSr: case BEQr: case BMIr: case BNEr: case BPLr:
     case BVCr: case BVSr:
-        fprintf(cpu.m_fdbg, "r  #%02x", endian_16lo8 (cpu.instrOperand));
-        fprintf(cpu.m_fdbg, " [%04x]", cpu.Cycle_EffectiveAddress);
+        fprintf(out, "r  #%02x", endian_16lo8 (record.operand));
+        fprintf(out, " [%04x]", record.address);
     break;
 
     //Indirect Addressing Mode Handler
     case JMPi:
-        fprintf(cpu.m_fdbg, "i  (%04x)", cpu.instrOperand);
-        fprintf(cpu.m_fdbg, " [%04x]", cpu.Cycle_EffectiveAddress);
+        fprintf(out, "i  (%04x)", record.operand);
+        fprintf(out, " [%04x]", record.address);
     break;
 
     //Indexed with X Preinc Addressing Mode Handler
@@ -451,12 +436,12 @@ void MOS6510Debug::DumpState (event_clock_t time, MOS6510 &cpu)
     case LAXix: case LDAix: case ORAix: case SBCix: case SLOix: case SREix:
     case RLAix: case RRAix:
     //ASOix AXSix DCMix INSix LSEix - Optional Opcode Names
-        fprintf(cpu.m_fdbg, "ix (%02x,X)", endian_16lo8 (cpu.instrOperand));
-        fprintf(cpu.m_fdbg, " [%04x]{%02x}", cpu.Cycle_EffectiveAddress, cpu.Cycle_Data);
+        fprintf(out, "ix (%02x,X)", endian_16lo8 (record.operand));
+        fprintf(out, " [%04x]{%02x}", record.address, record.data);
     break;
     case SAXix: case STAix:
-        fprintf(cpu.m_fdbg, "ix (%02x,X)", endian_16lo8 (cpu.instrOperand));
-        fprintf(cpu.m_fdbg, " [%04x]", cpu.Cycle_EffectiveAddress);
+        fprintf(out, "ix (%02x,X)", endian_16lo8 (record.operand));
+        fprintf(out, " [%04x]", record.address);
     break;
 
     //Indexed with Y Postinc Addressing Mode Handler
@@ -464,22 +449,46 @@ void MOS6510Debug::DumpState (event_clock_t time, MOS6510 &cpu)
     case LAXiy: case LDAiy: case ORAiy: case RLAiy: case RRAiy: case SBCiy:
     case SLOiy: case SREiy:
     //AXAiy ASOiy LSEiy DCMiy INSiy - Optional Opcode Names
-        fprintf(cpu.m_fdbg, "iy (%02x),Y", endian_16lo8 (cpu.instrOperand));
-        fprintf(cpu.m_fdbg, " [%04x]{%02x}", cpu.Cycle_EffectiveAddress, cpu.Cycle_Data);
+        fprintf(out, "iy (%02x),Y", endian_16lo8 (record.operand));
+        fprintf(out, " [%04x]{%02x}", record.address, record.data);
     break;
     case SHAiy: case STAiy:
-        fprintf(cpu.m_fdbg, "iy (%02x),Y", endian_16lo8 (cpu.instrOperand));
-        fprintf(cpu.m_fdbg, " [%04x]", cpu.Cycle_EffectiveAddress);
+        fprintf(out, "iy (%02x),Y", endian_16lo8 (record.operand));
+        fprintf(out, " [%04x]", record.address);
     break;
 
     default:
     break;
     }
 
-    fprintf(cpu.m_fdbg, "\n\n");
-    fflush(cpu.m_fdbg);
+    fprintf(out, "\n\n");
 }
 
+void MOS6510Debug::DumpTrace(FILE *out, const CpuTraceRecord &record)
+{
+    if (record.opcode == RTIn)
+    {
+        fprintf(out, "****************************************************\n\n");
+    }
+
+    if (record.flags & CpuTraceRecord::INTERRUPT)
+    {
+        fprintf(out, "****************************************************\n");
+        fprintf(out, " interrupt (%d)\n", static_cast<int>(record.time));
+        fprintf(out, "****************************************************\n");
+    }
+
+    DumpRecord(out, record);
 }
 
+#ifdef DEBUG
+void MOS6510Debug::DumpState(event_clock_t time, MOS6510 &cpu)
+{
+    CpuTraceRecord record;
+    cpu.traceRecord(record, time, 0);
+    DumpRecord(cpu.m_fdbg, record);
+    fflush(cpu.m_fdbg);
+}
 #endif
+
+}
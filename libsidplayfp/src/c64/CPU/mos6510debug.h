@@ -23,13 +23,17 @@
 #ifndef MOS6510DEBUG_H
 #define MOS6510DEBUG_H
 
+#include <cstdio>
+
+#include "sidplayfp/cputrace.h"
+
 #ifdef HAVE_CONFIG_H
 #  include "config.h"
 #endif
 
 #ifdef DEBUG
-
-#include "EventScheduler.h"
+#  include "EventScheduler.h"
+#endif
 
 namespace libsidplayfp
 {
@@ -38,11 +42,22 @@ class MOS6510;
 
 namespace MOS6510Debug
 {
+    /**
+     * Write a trace record in the text format of the debug dump.
+     */
+    void DumpRecord(FILE *out, const CpuTraceRecord &record);
+
+    /**
+     * Write a trace record preceded by the interrupt
+     * and RTI separators of the debug dump.
+     */
+    void DumpTrace(FILE *out, const CpuTraceRecord &record);
+
+#ifdef DEBUG
     void DumpState(event_clock_t time, MOS6510 &cpu);
+#endif
 }
 
 }
 
-#endif
-
 #endif // MOS6510DEBUG_H
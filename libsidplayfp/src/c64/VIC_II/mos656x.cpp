@@ -58,7 +58,7 @@ const char *MOS656X::credit =
 };
 
 
-MOS656X::MOS656X(EventContext *context) :
+MOS656X::MOS656X(event_context_t *context) :
     Event("VIC Raster"),
     event_context(*context),
     sprites(regs),
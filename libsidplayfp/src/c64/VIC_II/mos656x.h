@@ -86,7 +86,7 @@ private:
     event_clock_t rasterClk;
 
     /// CPU's event context.
-    EventContext &event_context;
+    event_context_t &event_context;
 
     /// Number of cycles per line.
     unsigned int cyclesPerLine;
@@ -297,7 +297,7 @@ private:
     }
 
 protected:
-    MOS656X(EventContext *context);
+    MOS656X(event_context_t *context);
     ~MOS656X() {}
 
     // Environment Interface
@@ -72,7 +72,11 @@ c64::c64() :
     cia1(this),
     cia2(this),
     vic(this),
-    mmu(&m_scheduler, &ioBank)
+    mmu(&m_scheduler, &ioBank),
+    watchpoints(m_scheduler, cpu),
+    m_trace(nullptr),
+    m_sidCapture(nullptr),
+    m_extraSids(0)
 {
     resetIoBank();
 }
@@ -152,14 +156,16 @@ bool c64::addExtraSid(c64sid *s, int address)
     if (it != extraSidBanks.end())
     {
          ExtraSidBank *extraSidBank = it->second;
-         extraSidBank->addSID(s, address);
+         extraSidBank->addSID(s, address, ++m_extraSids);
     }
     else
     {
         ExtraSidBank *extraSidBank = extraSidBanks.insert(it, sidBankMap_t::value_type(idx, new ExtraSidBank()))->second;
         extraSidBank->resetSIDMapper(ioBank.getBank(idx));
+        extraSidBank->setTrace(m_trace);
+        extraSidBank->setCapture(m_sidCapture);
         ioBank.setBank(idx, extraSidBank);
-        extraSidBank->addSID(s, address);
+        extraSidBank->addSID(s, address, ++m_extraSids);
     }
 
     return true;
@@ -177,6 +183,49 @@ void c64::clearSids()
     std::for_each(extraSidBanks.begin(), extraSidBanks.end(), Delete<sidBankMap_t::value_type>);
 
     extraSidBanks.clear();
+
+    m_extraSids = 0;
+}
+
+void c64::setTrace(ChromeTrace *trace)
+{
+    m_trace = trace;
+
+    m_scheduler.setTrace(trace);
+    cpu.setTrace(trace);
+    sidBank.setTrace(trace);
+
+    for (sidBankMap_t::iterator it = extraSidBanks.begin(); it != extraSidBanks.end(); ++it)
+        it->second->setTrace(trace);
+}
+
+void c64::setSidCapture(SidCapture *capture)
+{
+    m_sidCapture = capture;
+
+    sidBank.setCapture(capture);
+
+    for (sidBankMap_t::iterator it = extraSidBanks.begin(); it != extraSidBanks.end(); ++it)
+        it->second->setCapture(capture);
+}
+
+void c64::addWatch(uint_least16_t start, uint_least16_t end, uint8_t access)
+{
+    watchpoints.add(start, end, access);
+    attachWatchpoints();
+}
+
+void c64::clearWatches()
+{
+    watchpoints.clear();
+    attachWatchpoints();
+}
+
+void c64::attachWatchpoints()
+{
+    const bool any = watchpoints.watches(WATCH_READ | WATCH_WRITE | WATCH_EXECUTE);
+    mmu.setWatchpoints(any ? &watchpoints : nullptr);
+    cpu.setWatchpoints(watchpoints.watches(WATCH_EXECUTE) ? &watchpoints : nullptr);
 }
 
 }
@@ -41,6 +41,7 @@
 #include "c64/c64cia.h"
 #include "c64/c64vic.h"
 #include "c64/mmu.h"
+#include "c64/watchpoints.h"
 
 #include "sidcxx11.h"
 
@@ -136,8 +137,20 @@ private:
     /// MMU chip
     MMU mmu;
 
+    /// Watched CPU accesses
+    Watchpoints watchpoints;
+
+    /// Tracing sink, null if tracing is disabled
+    ChromeTrace *m_trace;
+
+    /// SID write capture, null if disabled
+    SidCapture *m_sidCapture;
+
+    /// Number of extra SIDs
+    int m_extraSids;
+
 private:
-    static double getCpuFreq(model_t model);
+    void attachWatchpoints();
 
 private:
     /**
@@ -148,6 +161,15 @@ private:
      */
     uint8_t cpuRead(uint_least16_t addr) override { return mmu.cpuRead(addr); }
 
+    /**
+     * Check for how many cycles a CPU read keeps returning the same value.
+     *
+     * @param addr the address just read
+     * @param data the value read
+     * @return the number of cycles, 0 if it may change at any time
+     */
+    unsigned int cpuReadStable(uint_least16_t addr, uint8_t data) const override { return mmu.cpuReadStable(addr, data); }
+
     /**
      * Access memory as seen by CPU.
      *
@@ -156,6 +178,15 @@ private:
      */
     void cpuWrite(uint_least16_t addr, uint8_t data) override { mmu.cpuWrite(addr, data); }
 
+    /**
+     * Get the processor port registers, bypassing
+     * the memory access and its side effects.
+     */
+    //@{
+    uint8_t cpuPortDir() const override { return mmu.cpuPortDir(); }
+    uint8_t cpuPortData() const override { return mmu.cpuPortData(); }
+    //@}
+
     /**
      * IRQ trigger signal.
      *
@@ -242,6 +273,13 @@ public:
      */
     double getMainCpuSpeed() const { return m_cpuFreq; }
 
+    /**
+     * Get the CPU clock frequency of a model.
+     *
+     * @param model the C64 model
+     */
+    static double getCpuFreq(model_t model);
+
     /**
      * Set the base SID.
      *
@@ -265,6 +303,77 @@ public:
      */
     void clearSids();
 
+    /**
+     * Set the tracing sink for the scheduler,
+     * the CPU and the SID writes.
+     *
+     * @param trace the sink, null to disable tracing
+     */
+    void setTrace(ChromeTrace *trace);
+
+    /**
+     * Set the capture of the SID register writes.
+     *
+     * @param capture the capture, null to disable capturing
+     */
+    void setSidCapture(SidCapture *capture);
+
+    /**
+     * Set the profiler of the code run by the CPU.
+     *
+     * @param profiler the profiler, null to disable profiling
+     */
+    void setProfiler(CpuProfiler *profiler) { cpu.setProfiler(profiler); }
+
+    /**
+     * Set the meter of the interrupt driven play calls.
+     *
+     * @param playTime the meter, null to disable it
+     */
+    void setPlayTime(PlayTime *playTime) { cpu.setPlayTime(playTime); }
+
+    /**
+     * Set the buffer of the binary CPU trace.
+     *
+     * @param cpuTrace the buffer, null to disable tracing
+     */
+    void setCpuTrace(CpuTraceBuffer *cpuTrace) { cpu.setCpuTrace(cpuTrace); }
+
+    /**
+     * Watch CPU accesses to an address range.
+     *
+     * @param start the first address
+     * @param end the last address
+     * @param access combination of the watch_access_t values
+     */
+    void addWatch(uint_least16_t start, uint_least16_t end, uint8_t access);
+
+    /**
+     * Remove all watches.
+     */
+    void clearWatches();
+
+    /**
+     * Get the watch hits recorded since the previous call.
+     *
+     * @param hits the vector to fill
+     */
+    void getWatchHits(std::vector<WatchHit> &hits) { watchpoints.getHits(hits); }
+
+    /**
+     * Take a copy-on-write snapshot of the RAM.
+     *
+     * @param snapshot the snapshot to update
+     */
+    void saveRam(RamSnapshot &snapshot) { mmu.saveRam(snapshot); }
+
+    /**
+     * Restore a snapshot of the RAM.
+     *
+     * @param snapshot the snapshot, must not be empty
+     */
+    void restoreRam(const RamSnapshot &snapshot) { mmu.restoreRam(snapshot); }
+
     /**
      * Get the components credits
      */
@@ -82,6 +82,11 @@ public:
         return read(endian_16lo8(address));
     }
 
+    unsigned int stableCycles(uint_least16_t address, uint8_t value) const override
+    {
+        return MOS6526::stableCycles(endian_16lo8(address), value);
+    }
+
     void reset() override
     {
         last_ta = 0;
@@ -124,6 +129,11 @@ public:
     {
         return read(address);
     }
+
+    unsigned int stableCycles(uint_least16_t address, uint8_t value) const override
+    {
+        return MOS6526::stableCycles(address, value);
+    }
 };
 
 }
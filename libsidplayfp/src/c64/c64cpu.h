@@ -43,8 +43,28 @@ public:
         MOS6510(&(env->context())),
         m_env(*env) {}
 
-    uint8_t cpuRead(uint_least16_t addr) override { return m_env.cpuRead(addr); }
-    void cpuWrite(uint_least16_t addr, uint8_t data) override { m_env.cpuWrite(addr, data); }
+    uint8_t cpuRead(uint_least16_t addr) override
+    {
+        // the processor port and the I/O area may change over time
+        if (addr <= 0x0001 || (addr >> 12) == 0xd)
+        {
+            // the next event is due before the chips sync up
+            const event_clock_t free = m_env.context().freeCycles();
+            const uint8_t data = m_env.cpuRead(addr);
+            stableRead(m_env.cpuReadStable(addr, data), free);
+            return data;
+        }
+        return m_env.cpuRead(addr);
+    }
+
+    void cpuWrite(uint_least16_t addr, uint8_t data) override
+    {
+        volatileAccess();
+        m_env.cpuWrite(addr, data);
+    }
+
+    uint8_t cpuPortDir() const override { return m_env.cpuPortDir(); }
+    uint8_t cpuPortData() const override { return m_env.cpuPortData(); }
 
 #ifdef PC64_TESTSUITE
     void loadFile(const char *file) override { m_env.loadFile(file); }
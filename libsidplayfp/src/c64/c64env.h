@@ -23,7 +23,7 @@
 #ifndef C64ENV_H
 #define C64ENV_H
 
-#include "sidplayfp/event.h"
+#include "EventScheduler.h"
 
 #ifdef HAVE_CONFIG_H
 #  include "config.h"
@@ -40,17 +40,21 @@ namespace libsidplayfp
 class c64env
 {
 private:
-    EventContext &m_context;
+    cpu_event_context_t &m_context;
 
 public:
-    c64env(EventContext *context) :
+    c64env(cpu_event_context_t *context) :
         m_context(*context) {}
 
-    EventContext &context() const { return m_context; }
+    cpu_event_context_t &context() const { return m_context; }
 
     virtual uint8_t cpuRead(uint_least16_t addr) =0;
+    virtual unsigned int cpuReadStable(uint_least16_t addr, uint8_t data) const =0;
     virtual void cpuWrite(uint_least16_t addr, uint8_t data) =0;
 
+    virtual uint8_t cpuPortDir() const =0;
+    virtual uint8_t cpuPortData() const =0;
+
 #ifdef PC64_TESTSUITE
     virtual void loadFile(const char *file) =0;
 #endif
@@ -71,6 +71,12 @@ public:
     {
         return read(endian_16lo8(address));
     }
+
+    /// The registers only change in the VIC events
+    unsigned int stableCycles(uint_least16_t address SID_UNUSED, uint8_t value SID_UNUSED) const override
+    {
+        return UINT_MAX;
+    }
 };
 
 }
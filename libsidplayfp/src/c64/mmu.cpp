@@ -27,13 +27,22 @@ namespace libsidplayfp
 
 class Bank;
 
-MMU::MMU(EventContext *context, Bank* ioBank) :
+MMU::MMU(event_context_t *context, Bank* ioBank) :
     context(*context),
     loram(false),
     hiram(false),
     charen(false),
     ioBank(ioBank),
-    zeroRAMBank(this, &ramBank)
+    zeroRAMBank(this, &ramBank),
+    watchpoints(nullptr)
+{
+    mapFixedAreas();
+}
+
+/**
+ * Map the areas which don't depend on the processor port.
+ */
+void MMU::mapFixedAreas()
 {
     cpuReadMap[0] = &zeroRAMBank;
     cpuWriteMap[0] = &zeroRAMBank;
@@ -43,6 +52,81 @@ MMU::MMU(EventContext *context, Bank* ioBank) :
         cpuReadMap[i] = &ramBank;
         cpuWriteMap[i] = &ramBank;
     }
+
+    // The zero page holds the processor port
+    cpuReadPage[0] = nullptr;
+    cpuWritePage[0] = nullptr;
+}
+
+/**
+ * Get the memory backing a page as mapped for CPU reads.
+ */
+const uint8_t* MMU::readPage(unsigned int page) const
+{
+    const unsigned int chunk = page >> 4;
+    const Bank* bank = cpuReadMap[chunk];
+    const uint_least16_t addr = page << 8;
+
+    if (bank == &watchReadBanks[chunk])
+        bank = watchReadBanks[chunk].target();
+
+    if (bank == &ramBank || bank == &zeroRAMBank)
+        return ramBank.page(page);
+    if (bank == &kernalRomBank)
+        return kernalRomBank.page(addr);
+    if (bank == &basicRomBank)
+        return basicRomBank.page(addr);
+    if (bank == &characterRomBank)
+        return characterRomBank.page(addr);
+    return nullptr;
+}
+
+/**
+ * Get the memory backing a page as mapped for CPU writes.
+ */
+uint8_t* MMU::writePage(unsigned int page) const
+{
+    const unsigned int chunk = page >> 4;
+    const Bank* bank = cpuWriteMap[chunk];
+
+    if (bank == &watchWriteBanks[chunk])
+        bank = watchWriteBanks[chunk].target();
+
+    // Shared pages must be copied by the bank on the first write
+    if (bank == &ramBank || bank == &zeroRAMBank)
+        return ramBank.writablePage(page);
+    return nullptr;
+}
+
+/**
+ * Update the direct pointers of a page.
+ */
+void MMU::updatePage(unsigned int page)
+{
+    // The zero page holds the processor port
+    if (page == 0)
+        return;
+
+    cpuReadPage[page] = (watchpoints != nullptr && watchpoints->watches(page, WATCH_READ))
+        ? nullptr : readPage(page);
+    cpuWritePage[page] = (watchpoints != nullptr && watchpoints->watches(page, WATCH_WRITE))
+        ? nullptr : writePage(page);
+}
+
+/**
+ * Update the direct pointers of an area
+ * where the RAM pages may have been copied.
+ */
+void MMU::updatePages(uint_least16_t start, unsigned int size)
+{
+    if (size == 0)
+        return;
+
+    const unsigned int last = (start + size - 1) >> 8;
+    for (unsigned int page = start >> 8; page <= last && page < 0x100; page++)
+    {
+        updatePage(page);
+    }
 }
 
 void MMU::setCpuPort(int state)
@@ -53,6 +137,20 @@ void MMU::setCpuPort(int state)
     updateMappingPHI2();
 }
 
+void MMU::saveRam(RamSnapshot &snapshot)
+{
+    ramBank.save(snapshot);
+
+    // All the pages are shared now
+    updatePages(0, 0x10000);
+}
+
+void MMU::restoreRam(const RamSnapshot &snapshot)
+{
+    ramBank.restore(snapshot);
+    updatePages(0, 0x10000);
+}
+
 void MMU::updateMappingPHI2()
 {
     cpuReadMap[0xe] = cpuReadMap[0xf] = hiram ? (Bank*)&kernalRomBank : &ramBank;
@@ -67,6 +165,42 @@ void MMU::updateMappingPHI2()
         cpuReadMap[0xd] = (!charen && (loram || hiram)) ? (Bank*)&characterRomBank : &ramBank;
         cpuWriteMap[0xd] = &ramBank;
     }
+
+    if (watchpoints != nullptr)
+        applyWatchpoints();
+
+    // Only the BASIC, I/O and KERNAL areas depend on the processor port
+    updatePages(0xa000, 0x2000);
+    updatePages(0xd000, 0x3000);
+}
+
+/**
+ * Route the chunks with watched pages through the instrumented banks.
+ */
+void MMU::applyWatchpoints()
+{
+    for (unsigned int chunk = 0; chunk < 16; chunk++)
+    {
+        bool watchRead = false;
+        bool watchWrite = false;
+
+        for (unsigned int page = chunk << 4; page < (chunk + 1) << 4; page++)
+        {
+            watchRead |= watchpoints->watches(page, WATCH_READ);
+            watchWrite |= watchpoints->watches(page, WATCH_WRITE);
+        }
+
+        if (watchRead && cpuReadMap[chunk] != &watchReadBanks[chunk])
+        {
+            watchReadBanks[chunk].set(cpuReadMap[chunk], watchpoints);
+            cpuReadMap[chunk] = &watchReadBanks[chunk];
+        }
+        if (watchWrite && cpuWriteMap[chunk] != &watchWriteBanks[chunk])
+        {
+            watchWriteBanks[chunk].set(cpuWriteMap[chunk], watchpoints);
+            cpuWriteMap[chunk] = &watchWriteBanks[chunk];
+        }
+    }
 }
 
 void MMU::reset()
@@ -79,6 +213,9 @@ void MMU::reset()
     basicRomBank.reset();
 
     updateMappingPHI2();
+
+    // All the pages are shared with the powerup pattern now
+    updatePages(0, 0x10000);
 }
 
 }
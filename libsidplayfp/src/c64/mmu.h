@@ -25,7 +25,7 @@
 
 #include <stdint.h>
 
-#include "sidplayfp/event.h"
+#include "EventScheduler.h"
 #include "sidendian.h"
 #include "sidmemory.h"
 
@@ -33,6 +33,9 @@
 #include "Banks/SystemRAMBank.h"
 #include "Banks/SystemROMBanks.h"
 #include "Banks/ZeroRAMBank.h"
+#include "Banks/WatchBank.h"
+
+#include "c64/watchpoints.h"
 
 #include "sidcxx11.h"
 
@@ -47,7 +50,7 @@ namespace libsidplayfp
 class MMU : public PLA, public sidmemory
 {
 private:
-    EventContext &context;
+    event_context_t &context;
 
     /// CPU port signals
     bool loram, hiram, charen;
@@ -58,6 +61,14 @@ private:
     /// CPU write memory mapping in 4k chunks
     Bank* cpuWriteMap[16];
 
+    /// CPU read memory mapping in 256 byte pages backed by RAM or ROM,
+    /// null where the access must go through the bank
+    const uint8_t* cpuReadPage[0x100];
+
+    /// CPU write memory mapping in 256 byte pages backed by RAM,
+    /// null where the access must go through the bank
+    uint8_t* cpuWritePage[0x100];
+
     /// IO region handler
     Bank* ioBank;
 
@@ -76,6 +87,15 @@ private:
     /// RAM bank 0
     ZeroRAMBank zeroRAMBank;
 
+    /// Watched accesses, null if nothing is watched
+    Watchpoints* watchpoints;
+
+    /// Instrumented wrappers of the 4k chunks with watched reads
+    WatchBank watchReadBanks[16];
+
+    /// Instrumented wrappers of the 4k chunks with watched writes
+    WatchBank watchWriteBanks[16];
+
 private:
     void setCpuPort(int state) override;
     uint8_t getLastReadByte() const override { return 0; }
@@ -83,8 +103,20 @@ private:
 
     void updateMappingPHI2();
 
+    void mapFixedAreas();
+
+    void applyWatchpoints();
+
+    const uint8_t* readPage(unsigned int page) const;
+
+    uint8_t* writePage(unsigned int page) const;
+
+    void updatePage(unsigned int page);
+
+    void updatePages(uint_least16_t start, unsigned int size);
+
 public:
-    MMU(EventContext *context, Bank* ioBank);
+    MMU(event_context_t *context, Bank* ioBank);
     ~MMU() {}
 
     void reset();
@@ -96,22 +128,58 @@ public:
         characterRomBank.set(character);
     }
 
+    /// Processor port registers, read without side effects
+    //@{
+    uint8_t cpuPortDir() const { return zeroRAMBank.getDir(); }
+    uint8_t cpuPortData() const { return zeroRAMBank.getData(); }
+    //@}
+
     // RAM access methods
     uint8_t readMemByte(uint_least16_t addr) override { return ramBank.peek(addr); }
-    uint_least16_t readMemWord(uint_least16_t addr) override { return endian_little16(ramBank.ram+addr); }
+    uint_least16_t readMemWord(uint_least16_t addr) override
+    {
+        return endian_16(ramBank.peek(addr + 1), ramBank.peek(addr));
+    }
 
-    void writeMemByte(uint_least16_t addr, uint8_t value) override { ramBank.poke(addr, value); }
-    void writeMemWord(uint_least16_t addr, uint_least16_t value) override { endian_little16(ramBank.ram+addr, value); }
+    void writeMemByte(uint_least16_t addr, uint8_t value) override
+    {
+        ramBank.poke(addr, value);
+        updatePage(addr >> 8);
+    }
+    void writeMemWord(uint_least16_t addr, uint_least16_t value) override
+    {
+        writeMemByte(addr, endian_16lo8(value));
+        writeMemByte(addr + 1, endian_16hi8(value));
+    }
 
     void fillRam(uint_least16_t start, uint8_t value, unsigned int size) override
     {
-        memset(ramBank.ram+start, value, size);
+        ramBank.fill(start, value, size);
+        updatePages(start, size);
     }
     void fillRam(uint_least16_t start, const uint8_t* source, unsigned int size) override
     {
-        memcpy(ramBank.ram+start, source, size);
+        ramBank.fill(start, source, size);
+        updatePages(start, size);
     }
 
+    /**
+     * Take a snapshot of the RAM.
+     * The pages are shared with the snapshot and copied
+     * on the first write, so this only costs a walk of the
+     * page table plus the later copy of the pages touched.
+     *
+     * @param snapshot the snapshot to update
+     */
+    void saveRam(RamSnapshot &snapshot);
+
+    /**
+     * Restore a snapshot of the RAM.
+     *
+     * @param snapshot the snapshot, must not be empty
+     */
+    void restoreRam(const RamSnapshot &snapshot);
+
     // SID specific hacks
     void installResetHook(uint_least16_t addr) override { kernalRomBank.installResetHook(addr); }
 
@@ -119,13 +187,43 @@ public:
 
     void setBasicSubtune(uint8_t tune) override { basicRomBank.setSubtune(tune); }
 
+    /**
+     * Route the watched pages through instrumented banks.
+     * Must be called again whenever the watches change.
+     *
+     * @param w the watchpoints, null if nothing is watched
+     */
+    void setWatchpoints(Watchpoints* w)
+    {
+        watchpoints = w;
+        mapFixedAreas();
+        updateMappingPHI2();
+        updatePages(0, 0x10000);
+    }
+
     /**
      * Access memory as seen by CPU.
      *
      * @param addr the address where to read from
      * @return value at address
      */
-    uint8_t cpuRead(uint_least16_t addr) const { return cpuReadMap[addr >> 12]->peek(addr); }
+    uint8_t cpuRead(uint_least16_t addr) const
+    {
+        const uint8_t* page = cpuReadPage[addr >> 8];
+        return page != nullptr ? page[addr & 0xff] : cpuReadMap[addr >> 12]->peek(addr);
+    }
+
+    /**
+     * Check for how many cycles a CPU read keeps returning the same value.
+     *
+     * @param addr the address just read
+     * @param data the value read
+     * @return the number of cycles, see Bank::stableCycles
+     */
+    unsigned int cpuReadStable(uint_least16_t addr, uint8_t data) const
+    {
+        return cpuReadPage[addr >> 8] != nullptr ? UINT_MAX : cpuReadMap[addr >> 12]->stableCycles(addr, data);
+    }
 
     /**
      * Access memory as seen by CPU.
@@ -133,7 +231,23 @@ public:
      * @param addr the address where to write
      * @param data the value to write
      */
-    void cpuWrite(uint_least16_t addr, uint8_t data) { cpuWriteMap[addr >> 12]->poke(addr, data); }
+    void cpuWrite(uint_least16_t addr, uint8_t data)
+    {
+        uint8_t* page = cpuWritePage[addr >> 8];
+        if (page != nullptr)
+        {
+            page[addr & 0xff] = data;
+        }
+        else
+        {
+            const uint8_t* before = ramBank.page(addr >> 8);
+            cpuWriteMap[addr >> 12]->poke(addr, data);
+
+            // A shared RAM page has got its own copy
+            if (ramBank.page(addr >> 8) != before)
+                updatePage(addr >> 8);
+        }
+    }
 };
 
 }
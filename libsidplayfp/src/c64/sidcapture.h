@@ -0,0 +1,103 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2015 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef SIDCAPTURE_H
+#define SIDCAPTURE_H
+
+#include <stdint.h>
+
+#include "sidplayfp/event.h"
+#include "sidplayfp/sidwrite.h"
+
+#include "sidcxx11.h"
+
+namespace libsidplayfp
+{
+
+/**
+ * Timestamps the SID register writes and passes them
+ * to the user sink and to the log.
+ *
+ * Like ChromeTrace the SID banks hold a pointer to the capture
+ * which is null when capturing is disabled.
+ */
+class SidCapture
+{
+private:
+    const EventContext &m_context;
+
+    SidWriteSink *m_sink;
+
+    SidWriteSink *m_log;
+
+public:
+    /**
+     * @param context the event context providing the time
+     */
+    SidCapture(const EventContext &context) :
+        m_context(context),
+        m_sink(nullptr),
+        m_log(nullptr) {}
+
+    /**
+     * Set the receiver of the writes.
+     *
+     * @param sink the receiver
+     */
+    void setSink(SidWriteSink *sink) { m_sink = sink; }
+
+    /**
+     * Set the log of the writes.
+     *
+     * @param log the log
+     */
+    void setLog(SidWriteSink *log) { m_log = log; }
+
+    /**
+     * Check if the writes have any receiver.
+     */
+    bool active() const { return m_sink != nullptr || m_log != nullptr; }
+
+    /**
+     * A SID register has been written.
+     *
+     * @param chip the SID chip number
+     * @param addr the register address
+     * @param data the written value
+     */
+    void write(unsigned int chip, uint_least16_t addr, uint8_t data)
+    {
+        const SidWrite w =
+        {
+            m_context.getTime(EVENT_CLOCK_PHI2),
+            static_cast<uint8_t>(chip),
+            static_cast<uint8_t>(addr & 0x1f),
+            data
+        };
+        if (m_sink != nullptr)
+            m_sink->write(w);
+        if (m_log != nullptr)
+            m_log->write(w);
+    }
+};
+
+}
+
+#endif // SIDCAPTURE_H
@@ -0,0 +1,94 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2015 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "watchpoints.h"
+
+#include <cstring>
+
+#include "c64/CPU/mos6510.h"
+
+namespace libsidplayfp
+{
+
+Watchpoints::Watchpoints(const EventContext &context, const MOS6510 &cpu) :
+    m_context(context),
+    m_cpu(cpu)
+{
+    clear();
+}
+
+void Watchpoints::add(uint_least16_t start, uint_least16_t end, uint8_t access)
+{
+    const Range range = { start, end, access };
+    m_ranges.push_back(range);
+
+    for (unsigned int page = start >> 8; page <= static_cast<unsigned int>(end >> 8); page++)
+    {
+        m_pages[page] |= access;
+    }
+}
+
+void Watchpoints::clear()
+{
+    m_ranges.clear();
+    m_hits.clear();
+    memset(m_pages, 0, sizeof(m_pages));
+}
+
+bool Watchpoints::watches(uint8_t access) const
+{
+    for (std::vector<Range>::const_iterator it = m_ranges.begin(); it != m_ranges.end(); ++it)
+    {
+        if (it->access & access)
+            return true;
+    }
+    return false;
+}
+
+void Watchpoints::hit(uint_least16_t addr, uint8_t value, uint8_t access)
+{
+    for (std::vector<Range>::const_iterator it = m_ranges.begin(); it != m_ranges.end(); ++it)
+    {
+        if ((it->access & access) && addr >= it->start && addr <= it->end)
+        {
+            if (m_hits.size() < MAX_HITS)
+            {
+                const WatchHit hit =
+                {
+                    m_context.getTime(EVENT_CLOCK_PHI2),
+                    addr,
+                    access == WATCH_EXECUTE ? addr : m_cpu.getInstructionPC(),
+                    value,
+                    access
+                };
+                m_hits.push_back(hit);
+            }
+            return;
+        }
+    }
+}
+
+void Watchpoints::getHits(std::vector<WatchHit> &hits)
+{
+    hits.clear();
+    hits.swap(m_hits);
+}
+
+}
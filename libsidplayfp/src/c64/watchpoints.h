@@ -0,0 +1,128 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2015 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef WATCHPOINTS_H
+#define WATCHPOINTS_H
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "sidplayfp/event.h"
+#include "sidplayfp/watch.h"
+
+namespace libsidplayfp
+{
+
+class MOS6510;
+
+/**
+ * Address ranges watched for CPU reads, writes or executions.
+ *
+ * The MMU only routes the watched pages through instrumented
+ * banks and the CPU only checks executions if some are watched,
+ * so there is no cost when nothing is watched.
+ */
+class Watchpoints
+{
+public:
+    /// Maximum number of hits kept until they are fetched
+    static const unsigned int MAX_HITS = 65536;
+
+private:
+    struct Range
+    {
+        uint_least16_t start;
+        uint_least16_t end;
+        uint8_t access;
+    };
+
+private:
+    const EventContext &m_context;
+
+    const MOS6510 &m_cpu;
+
+    std::vector<Range> m_ranges;
+
+    /// Accesses watched in each 256 byte page
+    uint8_t m_pages[0x100];
+
+    /// Hits not yet fetched
+    std::vector<WatchHit> m_hits;
+
+private:
+    void hit(uint_least16_t addr, uint8_t value, uint8_t access);
+
+public:
+    Watchpoints(const EventContext &context, const MOS6510 &cpu);
+
+    /**
+     * Watch an address range.
+     *
+     * @param start the first address
+     * @param end the last address
+     * @param access combination of the watch_access_t values
+     */
+    void add(uint_least16_t start, uint_least16_t end, uint8_t access);
+
+    /**
+     * Remove all watches and the pending hits.
+     */
+    void clear();
+
+    /**
+     * Check if an access to some page is watched.
+     *
+     * @param page the 256 byte page number
+     * @param access combination of the watch_access_t values
+     */
+    bool watches(unsigned int page, uint8_t access) const { return (m_pages[page] & access) != 0; }
+
+    /**
+     * Check if any access is watched.
+     *
+     * @param access combination of the watch_access_t values
+     */
+    bool watches(uint8_t access) const;
+
+    /**
+     * Record an access if it is watched.
+     *
+     * @param addr the accessed address
+     * @param value the value read or written
+     * @param access one of the watch_access_t values
+     */
+    void check(uint_least16_t addr, uint8_t value, uint8_t access)
+    {
+        if (m_pages[addr >> 8] & access)
+            hit(addr, value, access);
+    }
+
+    /**
+     * Get the hits recorded since the previous call.
+     *
+     * @param hits the vector to fill
+     */
+    void getHits(std::vector<WatchHit> &hits);
+};
+
+}
+
+#endif // WATCHPOINTS_H
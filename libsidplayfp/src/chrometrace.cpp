@@ -0,0 +1,129 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2015 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "chrometrace.h"
+
+namespace libsidplayfp
+{
+
+/// Track ids
+enum
+{
+    TRACK_EVENTS = 1,
+    TRACK_CPU,
+    TRACK_SID,
+    TRACK_MIXER
+};
+
+static const char *trackNames[] = { "Events", "CPU", "SID", "Mixer" };
+
+ChromeTrace::ChromeTrace(FILE *out, const EventContext &context) :
+    m_out(out),
+    m_context(context),
+    m_start(clock()),
+    m_instrStart(-1.),
+    m_instrPC(0),
+    m_instrOpcode(0)
+{
+    // JSON array format, the closing bracket is optional
+    // so the trace remains readable if the program is killed
+    fprintf(m_out, "[\n");
+    for (int i = 0; i < 4; i++)
+    {
+        fprintf(m_out, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+            i ? ",\n" : "", TRACK_EVENTS + i, trackNames[i]);
+    }
+}
+
+ChromeTrace::~ChromeTrace()
+{
+    endInstruction(now());
+    fprintf(m_out, "\n]\n");
+    fflush(m_out);
+}
+
+double ChromeTrace::now() const
+{
+    const event_phase_t phase = m_context.phase();
+    return static_cast<double>(m_context.getTime(phase)) + (phase == EVENT_CLOCK_PHI2 ? 0.5 : 0.);
+}
+
+void ChromeTrace::endInstruction(double time)
+{
+    if (m_instrStart < 0.)
+        return;
+
+    if (m_instrOpcode < 0)
+    {
+        fprintf(m_out, ",\n{\"name\":\"interrupt\",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.1f,\"dur\":%.1f,"
+            "\"args\":{\"pc\":\"$%04x\"}}",
+            TRACK_CPU, m_instrStart, time - m_instrStart, m_instrPC);
+    }
+    else
+    {
+        fprintf(m_out, ",\n{\"name\":\"$%04x\",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.1f,\"dur\":%.1f,"
+            "\"args\":{\"opcode\":\"$%02x\"}}",
+            m_instrPC, TRACK_CPU, m_instrStart, time - m_instrStart, m_instrOpcode);
+    }
+}
+
+void ChromeTrace::beginInstruction(uint_least16_t pc, int opcode)
+{
+    const double time = now();
+    endInstruction(time);
+
+    m_instrStart = time;
+    m_instrPC = pc;
+    m_instrOpcode = opcode;
+}
+
+void ChromeTrace::dispatch(const char *name)
+{
+    fprintf(m_out, ",\n{\"name\":\"%s\",\"cat\":\"event\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%d,\"ts\":%.1f}",
+        name, TRACK_EVENTS, now());
+}
+
+void ChromeTrace::instruction(uint_least16_t pc, uint8_t opcode)
+{
+    beginInstruction(pc, opcode);
+}
+
+void ChromeTrace::interrupt(uint_least16_t pc)
+{
+    beginInstruction(pc, -1);
+}
+
+void ChromeTrace::sidWrite(uint_least16_t addr, uint8_t data)
+{
+    fprintf(m_out, ",\n{\"name\":\"$%04x\",\"cat\":\"sid\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%d,\"ts\":%.1f,"
+        "\"args\":{\"value\":\"$%02x\"}}",
+        addr, TRACK_SID, now(), data);
+}
+
+void ChromeTrace::mix(unsigned int samples)
+{
+    const double cpuTime = static_cast<double>(clock() - m_start) * 1000000. / CLOCKS_PER_SEC;
+
+    fprintf(m_out, ",\n{\"name\":\"mix\",\"cat\":\"mixer\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%d,\"ts\":%.1f,"
+        "\"args\":{\"samples\":%u,\"cpu_us\":%.0f}}",
+        TRACK_MIXER, now(), samples, cpuTime);
+}
+
+}
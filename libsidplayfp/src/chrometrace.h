@@ -0,0 +1,128 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2015 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef CHROMETRACE_H
+#define CHROMETRACE_H
+
+#include <stdint.h>
+#include <cstdio>
+#include <ctime>
+
+#include "sidplayfp/event.h"
+
+namespace libsidplayfp
+{
+
+/**
+ * Tracing sink writing the emulation timeline in the
+ * Chrome trace event format, which can be loaded in
+ * chrome://tracing or Perfetto.
+ *
+ * Timestamps are C64 cycles, shown as microseconds by the viewers,
+ * with PHI2 events half a cycle after PHI1 ones.
+ * Each source gets its own track: scheduler events,
+ * CPU instructions, SID writes and mixer calls.
+ *
+ * Components hold a pointer to the sink which is null when
+ * tracing is disabled, so the only cost is a test of that pointer.
+ */
+class ChromeTrace
+{
+private:
+    FILE *m_out;
+
+    const EventContext &m_context;
+
+    /// Processor time at the start of the trace
+    clock_t m_start;
+
+    /// Start of the instruction being executed, -1 if none
+    double m_instrStart;
+
+    /// Address of the instruction being executed
+    uint_least16_t m_instrPC;
+
+    /// Opcode of the instruction being executed, -1 for interrupts
+    int m_instrOpcode;
+
+private:
+    double now() const;
+
+    void endInstruction(double time);
+
+    void beginInstruction(uint_least16_t pc, int opcode);
+
+public:
+    /**
+     * Start a trace.
+     *
+     * @param out the file where to write the trace
+     * @param context the event context providing the timestamps
+     */
+    ChromeTrace(FILE *out, const EventContext &context);
+
+    /**
+     * Flush the pending instruction and terminate the trace.
+     */
+    ~ChromeTrace();
+
+    /**
+     * An event has been fired.
+     *
+     * @param name the event name
+     */
+    void dispatch(const char *name);
+
+    /**
+     * The CPU has fetched an opcode.
+     *
+     * @param pc the address of the opcode
+     * @param opcode the opcode
+     */
+    void instruction(uint_least16_t pc, uint8_t opcode);
+
+    /**
+     * The CPU has started an interrupt sequence.
+     *
+     * @param pc the address of the interrupted instruction
+     */
+    void interrupt(uint_least16_t pc);
+
+    /**
+     * A SID register has been written.
+     *
+     * @param addr the full register address
+     * @param data the written value
+     */
+    void sidWrite(uint_least16_t addr, uint8_t data);
+
+    /**
+     * The mixer has produced samples.
+     * The processor time elapsed since the start of the trace
+     * is recorded too, to relate emulated time to real time.
+     *
+     * @param samples the number of produced samples
+     */
+    void mix(unsigned int samples);
+};
+
+}
+
+#endif // CHROMETRACE_H
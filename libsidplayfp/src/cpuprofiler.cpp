@@ -0,0 +1,224 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2015 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "cpuprofiler.h"
+
+#include <algorithm>
+
+#include "sidplayfp/SidTuneInfo.h"
+
+namespace libsidplayfp
+{
+
+/// JSR opcode
+const uint8_t OPCODE_JSR = 0x20;
+
+/// Maximum depth of the shadow call stack
+const unsigned int MAX_DEPTH = 256;
+
+/// Minimum share of the total cycles for instructions to be dumped
+const double DUMP_THRESHOLD = 0.001;
+
+/**
+ * Orders profile entries by decreasing cycles.
+ */
+static bool moreCycles(const ProfileEntry &a, const ProfileEntry &b)
+{
+    return a.cycles > b.cycles;
+}
+
+CpuProfiler::CpuProfiler(const EventContext &context) :
+    m_context(context),
+    m_instrCount(0x10000),
+    m_instrCycles(0x10000),
+    m_callCount(0x10000),
+    m_callCycles(0x10000),
+    m_interruptCycles(0),
+    m_current(-2),
+    m_start(0),
+    m_call(false),
+    m_callStart(0) {}
+
+void CpuProfiler::endInstruction(event_clock_t time)
+{
+    if (m_current >= 0)
+        m_instrCycles[m_current] += time - m_start;
+    else if (m_current == -1)
+        m_interruptCycles += time - m_start;
+}
+
+void CpuProfiler::instruction(uint_least16_t pc, uint8_t opcode, uint8_t sp)
+{
+    const event_clock_t time = now();
+    endInstruction(time);
+
+    // Routines return by pulling their return address off the stack
+    while (!m_stack.empty() && m_stack.back().sp < sp)
+    {
+        const Frame &frame = m_stack.back();
+        m_callCycles[frame.target] += time - frame.start;
+        m_stack.pop_back();
+    }
+
+    if (m_call)
+    {
+        if (m_stack.size() == MAX_DEPTH)
+            m_stack.erase(m_stack.begin());
+
+        const Frame frame = { pc, sp, m_callStart };
+        m_stack.push_back(frame);
+        m_callCount[pc]++;
+    }
+
+    m_call = opcode == OPCODE_JSR;
+    m_callStart = time;
+
+    m_instrCount[pc]++;
+    m_current = pc;
+    m_start = time;
+}
+
+void CpuProfiler::interrupt()
+{
+    const event_clock_t time = now();
+    endInstruction(time);
+
+    // The interrupt sequence is accounted to the handler
+    m_current = -1;
+    m_start = time;
+    m_call = true;
+    m_callStart = time;
+}
+
+void CpuProfiler::reset()
+{
+    const event_clock_t time = now();
+    endInstruction(time);
+
+    for (std::vector<Frame>::const_iterator it = m_stack.begin(); it != m_stack.end(); ++it)
+        m_callCycles[it->target] += time - it->start;
+
+    m_stack.clear();
+    m_current = -2;
+    m_call = false;
+}
+
+void CpuProfiler::collect(const std::vector<uint_least64_t> &count,
+                          const std::vector<uint_least64_t> &cycles,
+                          std::vector<ProfileEntry> &result)
+{
+    result.clear();
+    for (unsigned int addr = 0; addr < 0x10000; addr++)
+    {
+        if (count[addr] || cycles[addr])
+        {
+            const ProfileEntry entry = { static_cast<uint_least16_t>(addr), count[addr], cycles[addr] };
+            result.push_back(entry);
+        }
+    }
+    std::stable_sort(result.begin(), result.end(), moreCycles);
+}
+
+void CpuProfiler::get(std::vector<ProfileEntry> &instructions, std::vector<ProfileEntry> &calls) const
+{
+    const event_clock_t time = now();
+
+    std::vector<uint_least64_t> instrCycles(m_instrCycles);
+    if (m_current >= 0)
+        instrCycles[m_current] += time - m_start;
+
+    // Routines still running are accounted up to now
+    std::vector<uint_least64_t> callCycles(m_callCycles);
+    for (std::vector<Frame>::const_iterator it = m_stack.begin(); it != m_stack.end(); ++it)
+        callCycles[it->target] += time - it->start;
+
+    collect(m_instrCount, instrCycles, instructions);
+    collect(m_callCount, callCycles, calls);
+}
+
+/**
+ * Describe where an address lies.
+ */
+static const char *where(uint_least16_t addr, const SidTuneInfo &tune,
+                         uint_least16_t driverAddr, uint_least16_t driverLength)
+{
+    if (driverLength && addr >= driverAddr && addr - driverAddr < driverLength)
+        return "psiddrv";
+    if (tune.initAddr() && addr == tune.initAddr())
+        return "tune init";
+    if (tune.playAddr() && addr == tune.playAddr())
+        return "tune play";
+    if (addr >= tune.loadAddr() && static_cast<unsigned int>(addr - tune.loadAddr()) < tune.c64dataLen())
+        return "tune";
+    if (addr >= 0xe000)
+        return "kernal area";
+    if (addr >= 0xa000 && addr < 0xc000)
+        return "basic area";
+    if (addr >= 0xd000 && addr < 0xe000)
+        return "i/o area";
+    return "ram";
+}
+
+void CpuProfiler::dump(FILE *out, const SidTuneInfo &tune, uint_least16_t driverAddr, uint_least16_t driverLength) const
+{
+    std::vector<ProfileEntry> instructions;
+    std::vector<ProfileEntry> calls;
+    get(instructions, calls);
+
+    uint_least64_t totalCycles = m_interruptCycles;
+    uint_least64_t totalCount = 0;
+    for (std::vector<ProfileEntry>::const_iterator it = instructions.begin(); it != instructions.end(); ++it)
+    {
+        totalCycles += it->cycles;
+        totalCount += it->count;
+    }
+    const double total = totalCycles ? static_cast<double>(totalCycles) : 1.;
+
+    fprintf(out, "CPU profile: %llu cycles, %llu instructions, %llu cycles in interrupt sequences\n",
+        static_cast<unsigned long long>(totalCycles), static_cast<unsigned long long>(totalCount),
+        static_cast<unsigned long long>(m_interruptCycles));
+    fprintf(out, "Tune $%04x-$%04x, init $%04x, play $%04x",
+        tune.loadAddr(), (tune.loadAddr() + tune.c64dataLen() - 1) & 0xffff,
+        tune.initAddr(), tune.playAddr());
+    if (driverLength)
+        fprintf(out, ", psiddrv $%04x-$%04x", driverAddr, (driverAddr + driverLength - 1) & 0xffff);
+    fprintf(out, "\n\nRoutines (inclusive)\n");
+    fprintf(out, "%8s %14s %16s %7s  %s\n", "address", "calls", "cycles", "%", "where");
+    for (std::vector<ProfileEntry>::const_iterator it = calls.begin(); it != calls.end(); ++it)
+    {
+        fprintf(out, "   $%04x %14llu %16llu %6.2f%%  %s\n",
+            it->address, static_cast<unsigned long long>(it->count), static_cast<unsigned long long>(it->cycles),
+            100. * it->cycles / total, where(it->address, tune, driverAddr, driverLength));
+    }
+
+    fprintf(out, "\nInstructions\n");
+    fprintf(out, "%8s %14s %16s %7s  %s\n", "address", "executions", "cycles", "%", "where");
+    for (std::vector<ProfileEntry>::const_iterator it = instructions.begin(); it != instructions.end(); ++it)
+    {
+        if (it->cycles < DUMP_THRESHOLD * total)
+            break;
+
+        fprintf(out, "   $%04x %14llu %16llu %6.2f%%  %s\n",
+            it->address, static_cast<unsigned long long>(it->count), static_cast<unsigned long long>(it->cycles),
+            100. * it->cycles / total, where(it->address, tune, driverAddr, driverLength));
+    }
+}
+
+}
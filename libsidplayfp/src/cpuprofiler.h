@@ -0,0 +1,161 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2015 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef CPUPROFILER_H
+#define CPUPROFILER_H
+
+#include <stdint.h>
+#include <cstdio>
+
+#include <vector>
+
+#include "sidplayfp/event.h"
+#include "sidplayfp/profile.h"
+
+class SidTuneInfo;
+
+namespace libsidplayfp
+{
+
+/**
+ * Flat profiler of the code run by the CPU.
+ *
+ * Counts executions and cycles for each instruction address,
+ * an instruction lasting from its opcode fetch to the next one,
+ * and calls and inclusive cycles for each subroutine and
+ * interrupt handler, tracked with a shadow call stack
+ * based on the stack pointer.
+ *
+ * Idle loops are not skipped while profiling.
+ *
+ * Like ChromeTrace the CPU holds a pointer to the profiler
+ * which is null when profiling is disabled.
+ */
+class CpuProfiler
+{
+private:
+    /// A routine being executed
+    struct Frame
+    {
+        /// Entry point
+        uint_least16_t target;
+
+        /// Stack pointer on entry
+        uint8_t sp;
+
+        /// Time of the call
+        event_clock_t start;
+    };
+
+private:
+    const EventContext &m_context;
+
+    /// Executions of each instruction
+    std::vector<uint_least64_t> m_instrCount;
+
+    /// Cycles of each instruction
+    std::vector<uint_least64_t> m_instrCycles;
+
+    /// Calls of each routine
+    std::vector<uint_least64_t> m_callCount;
+
+    /// Inclusive cycles of each routine
+    std::vector<uint_least64_t> m_callCycles;
+
+    /// Shadow call stack
+    std::vector<Frame> m_stack;
+
+    /// Cycles of the interrupt sequences
+    uint_least64_t m_interruptCycles;
+
+    /// Address of the instruction being executed,
+    /// -1 during interrupt sequences, -2 if none
+    int m_current;
+
+    /// Start of the instruction being executed
+    event_clock_t m_start;
+
+    /// The next instruction is the entry point of a routine
+    bool m_call;
+
+    /// Time of the pending call
+    event_clock_t m_callStart;
+
+private:
+    event_clock_t now() const { return m_context.getTime(EVENT_CLOCK_PHI2); }
+
+    void endInstruction(event_clock_t time);
+
+    static void collect(const std::vector<uint_least64_t> &count,
+                        const std::vector<uint_least64_t> &cycles,
+                        std::vector<ProfileEntry> &result);
+
+public:
+    /**
+     * Start profiling.
+     *
+     * @param context the event context providing the time
+     */
+    CpuProfiler(const EventContext &context);
+
+    /**
+     * The CPU has fetched an opcode.
+     *
+     * @param pc the address of the opcode
+     * @param opcode the opcode
+     * @param sp the stack pointer
+     */
+    void instruction(uint_least16_t pc, uint8_t opcode, uint8_t sp);
+
+    /**
+     * The CPU has started an interrupt sequence.
+     */
+    void interrupt();
+
+    /**
+     * The machine is going to be reset.
+     * Routines being executed are accounted up to now
+     * and abandoned, the collected data is kept.
+     */
+    void reset();
+
+    /**
+     * Get the profile sorted by decreasing cycles.
+     *
+     * @param instructions the vector to fill with the instruction profile
+     * @param calls the vector to fill with the routine profile
+     */
+    void get(std::vector<ProfileEntry> &instructions, std::vector<ProfileEntry> &calls) const;
+
+    /**
+     * Write the profile as text, annotating each address
+     * as part of the tune, of the PSID driver or of the ROMs.
+     *
+     * @param out the file where to write
+     * @param tune the loaded tune
+     * @param driverAddr the address of the PSID driver
+     * @param driverLength the length of the PSID driver, 0 if not installed
+     */
+    void dump(FILE *out, const SidTuneInfo &tune, uint_least16_t driverAddr, uint_least16_t driverLength) const;
+};
+
+}
+
+#endif // CPUPROFILER_H
@@ -0,0 +1,130 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2015 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "cputracebuffer.h"
+
+#include <cstring>
+
+namespace libsidplayfp
+{
+
+CpuTraceBuffer::CpuTraceBuffer(unsigned int size) :
+    m_records(size + 1),
+    m_pos(0),
+    m_written(0),
+    m_started(0) {}
+
+uint_least64_t CpuTraceBuffer::written() const
+{
+#ifdef HAVE_CXX11
+    return m_written.load(std::memory_order_acquire);
+#else
+    return m_written;
+#endif
+}
+
+uint_least64_t CpuTraceBuffer::started() const
+{
+#ifdef HAVE_CXX11
+    return m_started.load(std::memory_order_relaxed);
+#else
+    return m_started;
+#endif
+}
+
+void CpuTraceBuffer::push(const CpuTraceRecord &record)
+{
+    if (record.flags & CpuTraceRecord::JAM)
+    {
+        const CpuTraceRecord &last = m_records[(m_pos ? m_pos : m_records.size()) - 1];
+        if ((last.flags & CpuTraceRecord::JAM) && last.pc == record.pc)
+            return;
+    }
+
+    // Announce the slot reuse before overwriting it
+#ifdef HAVE_CXX11
+    const uint_least64_t count = m_written.load(std::memory_order_relaxed) + 1;
+    m_started.store(count, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+#else
+    const uint_least64_t count = m_written + 1;
+    m_started = count;
+#endif
+
+    m_records[m_pos] = record;
+    if (++m_pos == m_records.size())
+        m_pos = 0;
+
+#ifdef HAVE_CXX11
+    m_written.store(count, std::memory_order_release);
+#else
+    m_written = count;
+#endif
+}
+
+uint_least64_t CpuTraceBuffer::get(std::vector<CpuTraceRecord> &records) const
+{
+    const uint_least64_t slots = m_records.size();
+    const uint_least64_t size = slots - 1;
+
+    const uint_least64_t end = written();
+    uint_least64_t begin = end > size ? end - size : 0;
+
+    records.resize(static_cast<size_t>(end - begin));
+    for (uint_least64_t i = begin; i < end; i++)
+        records[static_cast<size_t>(i - begin)] = m_records[static_cast<size_t>(i % slots)];
+
+    // Drop the records whose slots the writer has started
+    // to reuse meanwhile
+#ifdef HAVE_CXX11
+    std::atomic_thread_fence(std::memory_order_acquire);
+#endif
+    const uint_least64_t now = started();
+    if (now > begin + slots)
+    {
+        const uint_least64_t first = now - slots;
+        const size_t drop = static_cast<size_t>(first < end ? first - begin : end - begin);
+        records.erase(records.begin(), records.begin() + drop);
+    }
+
+    return end;
+}
+
+bool CpuTraceBuffer::dump(FILE *out) const
+{
+    std::vector<CpuTraceRecord> records;
+    const uint_least64_t total = get(records);
+
+    CpuTraceHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, "SIDCPUTR", sizeof(header.magic));
+    header.version = 1;
+    header.recordSize = sizeof(CpuTraceRecord);
+    header.written = total;
+    header.records = static_cast<uint32_t>(records.size());
+
+    if (fwrite(&header, sizeof(header), 1, out) != 1)
+        return false;
+
+    return records.empty()
+        || fwrite(&records[0], sizeof(CpuTraceRecord), records.size(), out) == records.size();
+}
+
+}
@@ -0,0 +1,119 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2015 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef CPUTRACEBUFFER_H
+#define CPUTRACEBUFFER_H
+
+#include <stdint.h>
+#include <cstdio>
+
+#include <vector>
+
+#include "sidplayfp/cputrace.h"
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#ifdef HAVE_CXX11
+#  include <atomic>
+#endif
+
+namespace libsidplayfp
+{
+
+/**
+ * Fixed size ring buffer keeping the last binary CPU trace records.
+ *
+ * The emulation thread is the only writer and never waits;
+ * other threads can take a snapshot at any time, records
+ * overwritten while being copied are discarded.
+ * This works like a seqlock: the writer announces each record
+ * before storing it and publishes it after, the readers
+ * check the announced count after copying and drop the slots
+ * which may have been reused meanwhile.
+ * Without C++11 atomics there are no memory fences, so
+ * a snapshot is only reliable while the writer is stopped.
+ *
+ * Like ChromeTrace the CPU holds a pointer to the buffer
+ * which is null when tracing is disabled.
+ */
+class CpuTraceBuffer
+{
+private:
+    /// One slot more than the records to keep, for the one being written
+    std::vector<CpuTraceRecord> m_records;
+
+    /// Slot of the next record
+    unsigned int m_pos;
+
+    /// Records written so far
+#ifdef HAVE_CXX11
+    std::atomic<uint_least64_t> m_written;
+#else
+    volatile uint_least64_t m_written;
+#endif
+
+    /// Records written so far, plus the one being written if any
+#ifdef HAVE_CXX11
+    std::atomic<uint_least64_t> m_started;
+#else
+    volatile uint_least64_t m_started;
+#endif
+
+private:
+    uint_least64_t written() const;
+    uint_least64_t started() const;
+
+public:
+    /**
+     * Create the buffer.
+     *
+     * @param size the number of records to keep
+     */
+    CpuTraceBuffer(unsigned int size);
+
+    /**
+     * Append a record, overwriting the oldest one if full.
+     * Repeated records of a jammed CPU are dropped.
+     */
+    void push(const CpuTraceRecord &record);
+
+    /**
+     * Get the kept records, from the oldest to the newest.
+     * Can be called while the writer runs.
+     *
+     * @param records the vector to fill
+     * @return the total number of records written
+     */
+    uint_least64_t get(std::vector<CpuTraceRecord> &records) const;
+
+    /**
+     * Write the kept records to a binary trace file.
+     *
+     * @param out the file where to write
+     * @return false on write errors
+     */
+    bool dump(FILE *out) const;
+};
+
+}
+
+#endif // CPUTRACEBUFFER_H
@@ -25,6 +25,7 @@
 #include <algorithm>
 
 #include "sidemu.h"
+#include "chrometrace.h"
 
 void clockChip(sidemu *s) { s->clock(); }
 
@@ -38,24 +39,6 @@ private:
     int pos;
 };
 
-class bufferMove
-{
-public:
-    bufferMove(int p, int s) : pos(p), samples(s) {}
-    void operator()(short *dest)
-    {
-        const short* src = dest + pos;
-        for (int j = 0; j < samples; j++)
-        {
-            dest[j] = src[j];
-        }
-    }
-
-private:
-    int pos;
-    int samples;
-};
-
 void Mixer::clockChips()
 {
     std::for_each(m_chips.begin(), m_chips.end(), clockChip);
@@ -64,31 +47,40 @@ void Mixer::clockChips()
 void Mixer::resetBufs()
 {
     std::for_each(m_chips.begin(), m_chips.end(), bufferPos(0));
+    m_readPos = 0;
+}
+
+unsigned int Mixer::samplesAvailable() const
+{
+    // NB: if more than one chip exists, their bufferpos is identical to first chip's.
+    return (m_chips.front()->bufferpos() - m_readPos) & (sidemu::OUTPUTBUFFERSIZE - 1);
+}
+
+uint_least32_t Mixer::samplesNeeded() const
+{
+    const unsigned int channels = m_stereo ? 2 : 1;
+    const uint_least32_t frames = (m_sampleCount - m_sampleIndex) / channels;
+    const uint_least32_t samples = frames * m_fastForwardFactor;
+    const unsigned int available = samplesAvailable();
+
+    return (samples > available) ? samples - available : 0;
 }
 
 void Mixer::doMix()
 {
     short *buf = m_sampleBuffer + m_sampleIndex;
+    const uint_least32_t startIndex = m_sampleIndex;
 
     // extract buffer info now that the SID is updated.
     // clock() may update bufferpos.
-    // NB: if more than one chip exists, their bufferpos is identical to first chip's.
-    const int sampleCount = m_chips.front()->bufferpos();
+    unsigned int available = samplesAvailable();
 
-    int i = 0;
-    while (i < sampleCount)
-    {
-        /* Handle whatever output the sid has generated so far */
-        if (m_sampleIndex >= m_sampleCount)
-        {
-            break;
-        }
-        /* Are there enough samples to generate the next one? */
-        if (i + m_fastForwardFactor >= sampleCount)
-        {
-            break;
-        }
+    const unsigned int mask = sidemu::OUTPUTBUFFERSIZE - 1;
 
+    /* Handle whatever output the sid has generated so far */
+    while (m_sampleIndex < m_sampleCount
+        && available >= static_cast<unsigned int>(m_fastForwardFactor))
+    {
         const int dither = triangularDithering();
 
         /* This is a crude boxcar low-pass filter to
@@ -96,18 +88,19 @@ void Mixer::doMix()
         for (size_t k = 0; k < m_buffers.size(); k++)
         {
             int_least32_t sample = 0;
-            const short *buffer = m_buffers[k] + i;
+            const short *buffer = m_buffers[k];
             for (int j = 0; j < m_fastForwardFactor; j++)
             {
-                sample += buffer[j];
+                sample += buffer[(m_readPos + j) & mask];
             }
 
             m_iSamples[k] = (sample * m_volume[k] + dither) / VOLUME_MAX;
             m_iSamples[k] /= m_fastForwardFactor;
         }
 
-        /* increment i to mark we ate some samples, finish the boxcar thing. */
-        i += m_fastForwardFactor;
+        /* advance the read position to mark we ate some samples, finish the boxcar thing. */
+        m_readPos = (m_readPos + m_fastForwardFactor) & mask;
+        available -= m_fastForwardFactor;
 
         const unsigned int channels = m_stereo ? 2 : 1;
         for (unsigned int k = 0; k < channels; k++)
@@ -117,16 +110,17 @@ void Mixer::doMix()
         }
     }
 
-    /* move the unhandled data to start of buffer, if any. */
-    const int samplesLeft = sampleCount - i;
-    std::for_each(m_buffers.begin(), m_buffers.end(), bufferMove(i, samplesLeft));
-    std::for_each(m_chips.begin(), m_chips.end(), bufferPos(samplesLeft - 1));
+    if (m_trace != nullptr)
+        m_trace->mix(m_sampleIndex - startIndex);
 }
 
 void Mixer::begin(short *buffer, uint_least32_t count)
 {
+    // Only whole frames fit in the buffer
+    const unsigned int channels = m_stereo ? 2 : 1;
+
     m_sampleIndex  = 0;
-    m_sampleCount  = count;
+    m_sampleCount  = count - count % channels;
     m_sampleBuffer = buffer;
 }
 
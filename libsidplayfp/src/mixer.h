@@ -33,6 +33,11 @@
 
 class sidemu;
 
+namespace libsidplayfp
+{
+    class ChromeTrace;
+}
+
 /**
  * This class implements the mixer.
  */
@@ -68,11 +73,22 @@ private:
     uint_least32_t m_sampleCount;
     uint_least32_t m_sampleIndex;
 
+    /// Read position in the chips' ring buffers
+    unsigned int m_readPos;
+
+    /// Tracing sink, null if tracing is disabled
+    libsidplayfp::ChromeTrace *m_trace;
+
     bool m_stereo;
 
 private:
     void updateParams();
 
+    /**
+     * Get the number of chip samples not yet mixed.
+     */
+    unsigned int samplesAvailable() const;
+
     int triangularDithering()
     {
         const int prevValue = oldRandomValue;
@@ -104,6 +120,8 @@ public:
         oldRandomValue(0),
         m_fastForwardFactor(1),
         m_sampleCount(0),
+        m_readPos(0),
+        m_trace(nullptr),
         m_stereo(false)
     {
         m_mix.push_back(&Mixer::mono_OneChip);
@@ -128,7 +146,8 @@ public:
      * Prepare for mixing cycle.
      *
      * @param buffer output buffer
-     * @param count size of the buffer in samples
+     * @param count size of the buffer in samples,
+     *              rounded down to a whole number of frames
      */
     void begin(short *buffer, uint_least32_t count);
 
@@ -168,6 +187,13 @@ public:
      */
     void setVolume(int_least32_t left, int_least32_t right);
 
+    /**
+     * Set the tracing sink.
+     *
+     * @param trace the sink, null to disable tracing
+     */
+    void setTrace(libsidplayfp::ChromeTrace *trace) { m_trace = trace; }
+
     /**
      * Set mixing mode.
      *
@@ -180,6 +206,12 @@ public:
      */
     bool notFinished() const { return m_sampleIndex != m_sampleCount; }
 
+    /**
+     * Get the number of chip samples still needed
+     * to fill the buffer.
+     */
+    uint_least32_t samplesNeeded() const;
+
     /**
      * Get the number of samples generated up to now.
      */
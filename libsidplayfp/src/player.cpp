@@ -23,6 +23,9 @@
 
 #include "player.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "sidplayfp/SidTune.h"
 #include "sidplayfp/sidbuilder.h"
 
@@ -51,18 +54,26 @@ const char ERR_UNSUPPORTED_FREQ[]     = "SIDPLAYER ERROR: Unsupported sampling f
 const char ERR_UNSUPPORTED_SID_ADDR[] = "SIDPLAYER ERROR: Unsupported SID address.";
 const char ERR_UNSUPPORTED_SIZE[]     = "SIDPLAYER ERROR: Size of music data exceeds C64 memory.";
 const char ERR_INVALID_PERCENTAGE[]   = "SIDPLAYER ERROR: Percentage value out of range.";
+const char ERR_TUNE_LOADED[]          = "SIDPLAYER ERROR: Can't inject SID writes with a tune loaded.";
+const char ERR_SID_LOG_ACTIVE[]       = "SIDPLAYER ERROR: Can't reconfigure while logging the SID writes.";
 
 Player::Player() :
     // Set default settings for system
     m_tune(nullptr),
     m_errorString(ERR_NA),
-    m_isPlaying(false)
+    m_isPlaying(false),
+    m_playTime(*m_c64.getEventScheduler()),
+    m_sidCapture(*m_c64.getEventScheduler()),
+    m_captureOnly(false)
 {
+    memset(&m_logHeader, 0, sizeof(m_logHeader));
+
 #ifdef PC64_TESTSUITE
     m_c64.setTestEnv(this);
 #endif
 
     m_c64.setRoms(nullptr, nullptr, nullptr);
+    m_c64.setPlayTime(&m_playTime);
     config(m_cfg);
 
     // Get component credits
@@ -107,7 +118,19 @@ void Player::initialise()
 {
     m_isPlaying = false;
 
+    // The timeline restarts from zero
+    if (m_profiler.get() != nullptr)
+        m_profiler->reset();
+
+    // The log time restarts from zero too
+    if (m_sidLog.get() != nullptr)
+        m_sidLog->reset(m_c64.getEventScheduler()->getTime(EVENT_CLOCK_PHI2));
+
     m_c64.reset();
+    m_mixer.resetBufs();
+
+    m_playTime.reset();
+    updatePlayTime();
 
     const SidTuneInfo* tuneInfo = m_tune->getInfo();
 
@@ -138,6 +161,13 @@ void Player::initialise()
 
 bool Player::load(SidTune *tune)
 {
+    // The log header describes the chips of the loaded tune
+    if (tune != nullptr && m_sidLog.get() != nullptr)
+    {
+        m_errorString = ERR_SID_LOG_ACTIVE;
+        return false;
+    }
+
     m_tune = tune;
 
     if (tune != nullptr)
@@ -153,6 +183,163 @@ bool Player::load(SidTune *tune)
     return true;
 }
 
+void Player::trace(FILE *out)
+{
+    // Detach the old sink before destroying it
+    m_c64.setTrace(nullptr);
+    m_mixer.setTrace(nullptr);
+
+    m_trace.reset(out != nullptr ? new ChromeTrace(out, *m_c64.getEventScheduler()) : nullptr);
+
+    m_c64.setTrace(m_trace.get());
+    m_mixer.setTrace(m_trace.get());
+}
+
+void Player::updatePlayTime()
+{
+    m_info.m_playCalls = m_playTime.count();
+    m_info.m_playCyclesMin = m_playTime.minCycles();
+    m_info.m_playCyclesAvg = m_playTime.avgCycles();
+    m_info.m_playCyclesMax = m_playTime.maxCycles();
+}
+
+void Player::profile(bool enable)
+{
+    // Detach the old profiler before destroying it
+    m_c64.setProfiler(nullptr);
+
+    m_profiler.reset(enable ? new CpuProfiler(*m_c64.getEventScheduler()) : nullptr);
+
+    m_c64.setProfiler(m_profiler.get());
+}
+
+bool Player::getProfile(std::vector<ProfileEntry> &instructions, std::vector<ProfileEntry> &calls) const
+{
+    if (m_profiler.get() == nullptr)
+    {
+        instructions.clear();
+        calls.clear();
+        return false;
+    }
+
+    m_profiler->get(instructions, calls);
+    return true;
+}
+
+bool Player::dumpProfile(FILE *out) const
+{
+    if (m_profiler.get() == nullptr || m_tune == nullptr)
+        return false;
+
+    m_profiler->dump(out, *m_tune->getInfo(), m_info.m_driverAddr, m_info.m_driverLength);
+    return true;
+}
+
+void Player::cpuTrace(unsigned int records)
+{
+    // Detach the old buffer before destroying it
+    m_c64.setCpuTrace(nullptr);
+
+    m_cpuTrace.reset(records ? new CpuTraceBuffer(records) : nullptr);
+
+    m_c64.setCpuTrace(m_cpuTrace.get());
+}
+
+bool Player::getCpuTrace(std::vector<CpuTraceRecord> &records) const
+{
+    if (m_cpuTrace.get() == nullptr)
+    {
+        records.clear();
+        return false;
+    }
+
+    m_cpuTrace->get(records);
+    return true;
+}
+
+bool Player::dumpCpuTrace(FILE *out) const
+{
+    return m_cpuTrace.get() != nullptr && m_cpuTrace->dump(out);
+}
+
+bool Player::addWatch(uint_least16_t start, uint_least16_t end, unsigned int access)
+{
+    access &= WATCH_READ | WATCH_WRITE | WATCH_EXECUTE;
+    if (access == 0 || start > end)
+        return false;
+
+    m_c64.addWatch(start, end, access);
+    return true;
+}
+
+void Player::saveRam(unsigned int slot)
+{
+    if (slot >= m_ramSnapshots.size())
+        m_ramSnapshots.resize(slot + 1);
+
+    m_c64.saveRam(m_ramSnapshots[slot]);
+}
+
+bool Player::restoreRam(unsigned int slot)
+{
+    if (slot >= m_ramSnapshots.size() || m_ramSnapshots[slot].empty())
+        return false;
+
+    m_c64.restoreRam(m_ramSnapshots[slot]);
+    return true;
+}
+
+bool Player::getRamSnapshot(unsigned int slot, uint8_t* buffer) const
+{
+    if (slot >= m_ramSnapshots.size() || m_ramSnapshots[slot].empty())
+        return false;
+
+    m_ramSnapshots[slot].read(buffer);
+    return true;
+}
+
+void Player::setSidWriteSink(SidWriteSink *sink)
+{
+    m_sidCapture.setSink(sink);
+    m_c64.setSidCapture(m_sidCapture.active() ? &m_sidCapture : nullptr);
+}
+
+bool Player::sidLog(FILE *out)
+{
+    // Detach the old log before destroying it
+    m_sidCapture.setLog(nullptr);
+    m_sidLog.reset(nullptr);
+
+    bool ok = true;
+    if (out != nullptr)
+    {
+        if (m_tune == nullptr)
+        {
+            ok = false;
+        }
+        else
+        {
+            m_sidLog.reset(new SidLogWriter(out, m_logHeader));
+            m_sidCapture.setLog(m_sidLog.get());
+            ok = !m_sidLog->failed();
+        }
+    }
+
+    m_c64.setSidCapture(m_sidCapture.active() ? &m_sidCapture : nullptr);
+    return ok;
+}
+
+bool Player::getEventStats(std::vector<EventStats> &stats) const
+{
+#ifdef EVENT_STATS
+    m_c64.getEventScheduler().getStats(stats);
+    return true;
+#else
+    stats.clear();
+    return false;
+#endif
+}
+
 void Player::mute(unsigned int sidNum, unsigned int voice, bool enable)
 {
     sidemu *s = m_mixer.getSid(sidNum);
@@ -175,10 +362,17 @@ uint_least32_t Player::play(short *buffer, uint_least32_t count)
     {
         if (count)
         {
+            const double cyclesPerSample = cpuFreq() / m_cfg.frequency;
+
             while (m_isPlaying && m_mixer.notFinished())
             {
-                for (int i = 0; i < sidemu::OUTPUTBUFFERSIZE; i++)
-                    m_c64.getEventScheduler()->clock();
+                // Run just as long as needed to produce the missing samples,
+                // filling at most half of the chips' ring buffers
+                const uint_least32_t samples = std::min<uint_least32_t>(
+                    m_mixer.samplesNeeded(), sidemu::OUTPUTBUFFERSIZE / 2);
+                const unsigned int cycles = static_cast<unsigned int>(samples * cyclesPerSample) + 1;
+
+                m_c64.getEventScheduler()->runCycles(cycles);
 
                 m_mixer.clockChips();
                 m_mixer.doMix();
@@ -190,8 +384,7 @@ uint_least32_t Player::play(short *buffer, uint_least32_t count)
             int size = m_c64.getMainCpuSpeed() / m_cfg.frequency;
             while (m_isPlaying && --size)
             {
-                for (int i = 0; i < sidemu::OUTPUTBUFFERSIZE; i++)
-                    m_c64.getEventScheduler()->clock();
+                m_c64.getEventScheduler()->runCycles(sidemu::OUTPUTBUFFERSIZE / 2);
 
                 m_mixer.clockChips();
                 m_mixer.resetBufs();
@@ -203,11 +396,12 @@ uint_least32_t Player::play(short *buffer, uint_least32_t count)
         int size = m_c64.getMainCpuSpeed() / m_cfg.frequency;
         while (m_isPlaying && --size)
         {
-            for (int i = 0; i < sidemu::OUTPUTBUFFERSIZE; i++)
-                m_c64.getEventScheduler()->clock();
+            m_c64.getEventScheduler()->runCycles(sidemu::OUTPUTBUFFERSIZE / 2);
         }
     }
 
+    updatePlayTime();
+
     if (!m_isPlaying)
     {
         try
@@ -220,6 +414,31 @@ uint_least32_t Player::play(short *buffer, uint_least32_t count)
     return count;
 }
 
+uint_least32_t Player::inject(const SidWrite *writes, unsigned int count, short *buffer, uint_least32_t samples)
+{
+    // The chips belong to the tune
+    if (m_tune != nullptr)
+    {
+        m_errorString = ERR_TUNE_LOADED;
+        return 0;
+    }
+
+    if (!m_injector.configured())
+    {
+        // Free the chips of the last tune
+        sidRelease();
+
+        if (!m_injector.config(m_cfg))
+        {
+            m_errorString = m_injector.error();
+            return 0;
+        }
+    }
+
+    m_injector.inject(writes, count);
+    return m_injector.play(buffer, samples);
+}
+
 void Player::stop()
 {   // Re-start song
     if (m_tune && m_isPlaying)
@@ -248,6 +467,16 @@ bool Player::config(const SidConfig &cfg)
         return false;
     }
 
+    // The log header describes the configured chips and clock
+    if (m_sidLog.get() != nullptr)
+    {
+        m_errorString = ERR_SID_LOG_ACTIVE;
+        return false;
+    }
+
+    // The injected writes are rendered with the new settings
+    m_injector.clear();
+
     uint_least16_t secondSidAddress = cfg.secondSidAddress;
 
     // Only do these if we have a loaded tune
@@ -276,6 +505,7 @@ bool Player::config(const SidConfig &cfg)
             const c64::model_t model = c64model(cfg.defaultC64Model, cfg.forceC64Model);
 
             m_c64.setModel(model);
+            m_logHeader.clock = static_cast<uint8_t>(model);
 
             sidParams(m_c64.getMainCpuSpeed(), cfg.frequency, cfg.samplingMethod, cfg.fastSampling);
 
@@ -447,13 +677,36 @@ void Player::sidRelease()
 void Player::sidCreate(sidbuilder *builder, SidConfig::sid_model_t defaultModel,
                         bool forced, const std::vector<unsigned int> &extraSidAddresses)
 {
-    if (builder != nullptr)
+    const SidTuneInfo* tuneInfo = m_tune->getInfo();
+
+    std::vector<SidConfig::sid_model_t> models;
+    models.push_back(getSidModel(tuneInfo->sidModel(0), defaultModel, forced));
+
+    // If bits 6-7 are set to Unknown then the extra SIDs will be set to the same SID
+    // model as the first SID.
+    for (unsigned int i = 0; i < extraSidAddresses.size(); i++)
+        models.push_back(getSidModel(tuneInfo->sidModel(i+1), models[0], forced));
+
+    // Describe the chips in the SID write logs
+    m_logHeader.chips = static_cast<uint8_t>(models.size());
+    for (unsigned int i = 0; i < models.size(); i++)
+        m_logHeader.models[i] = static_cast<uint8_t>(models[i]);
+
+    if (m_captureOnly)
     {
-        const SidTuneInfo* tuneInfo = m_tune->getInfo();
+        // No synthesis, the mixer gets no chips
+        m_c64.setBaseSid(&m_recordingSids[0]);
 
+        for (unsigned int i = 0; i < extraSidAddresses.size(); i++)
+        {
+            if (!m_c64.addExtraSid(&m_recordingSids[i + 1], extraSidAddresses[i]))
+                throw configError(ERR_UNSUPPORTED_SID_ADDR);
+        }
+    }
+    else if (builder != nullptr)
+    {
         // Setup base SID
-        const SidConfig::sid_model_t userModel = getSidModel(tuneInfo->sidModel(0), defaultModel, forced);
-        sidemu *s = builder->lock(m_c64.getEventScheduler(), userModel);
+        sidemu *s = builder->lock(m_c64.getEventScheduler(), models[0]);
         if (!builder->getStatus())
         {
             throw configError(builder->error());
@@ -463,25 +716,14 @@ void Player::sidCreate(sidbuilder *builder, SidConfig::sid_model_t defaultModel,
         m_mixer.addSid(s);
 
         // Setup extra SIDs if needed
-        if (extraSidAddresses.size() != 0)
+        for (unsigned int i = 0; i < extraSidAddresses.size(); i++)
         {
-            // If bits 6-7 are set to Unknown then the second SID will be set to the same SID
-            // model as the first SID.
-            defaultModel = userModel;
-
-            const unsigned int extraSidChips = extraSidAddresses.size();
+            sidemu *s = builder->lock(m_c64.getEventScheduler(), models[i + 1]);
 
-            for (unsigned int i = 0; i < extraSidChips; i++)
-            {
-                const SidConfig::sid_model_t userModel = getSidModel(tuneInfo->sidModel(i+1), defaultModel, forced);
-
-                sidemu *s = builder->lock(m_c64.getEventScheduler(), userModel);
+            if (!m_c64.addExtraSid(s, extraSidAddresses[i]))
+                throw configError(ERR_UNSUPPORTED_SID_ADDR);
 
-                if (!m_c64.addExtraSid(s, extraSidAddresses[i]))
-                    throw configError(ERR_UNSUPPORTED_SID_ADDR);
-
-                m_mixer.addSid(s);
-            }
+            m_mixer.addSid(s);
         }
     }
 }
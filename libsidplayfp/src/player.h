@@ -35,6 +35,14 @@
 #include "SidInfoImpl.h"
 #include "mixer.h"
 #include "c64/c64.h"
+#include "c64/sidcapture.h"
+#include "c64/Banks/RecordingSid.h"
+#include "chrometrace.h"
+#include "cpuprofiler.h"
+#include "playtime.h"
+#include "cputracebuffer.h"
+#include "sidlogwriter.h"
+#include "sidinjector.h"
 
 #ifdef HAVE_CONFIG_H
 #  include "config.h"
@@ -44,6 +52,7 @@
 #  include <string>
 #endif
 
+#include <memory>
 #include <vector>
 
 class SidTune;
@@ -97,6 +106,39 @@ private:
     /// PAL/NTSC switch value
     uint8_t videoSwitch;
 
+    /// Tracing sink
+    std::unique_ptr<ChromeTrace> m_trace;
+
+    /// CPU profiler
+    std::unique_ptr<CpuProfiler> m_profiler;
+
+    /// Play call meter
+    PlayTime m_playTime;
+
+    /// Binary CPU trace
+    std::unique_ptr<CpuTraceBuffer> m_cpuTrace;
+
+    /// Saved RAM images
+    std::vector<RamSnapshot> m_ramSnapshots;
+
+    /// SID write capture
+    SidCapture m_sidCapture;
+
+    /// Replace the SID emulations with recording only chips
+    bool m_captureOnly;
+
+    /// Recording only chips
+    RecordingSid m_recordingSids[3];
+
+    /// SID write log
+    std::unique_ptr<SidLogWriter> m_sidLog;
+
+    /// Description of the chips for the SID write logs
+    SidLogHeader m_logHeader;
+
+    /// Renderer of the injected SID writes
+    SidInjector m_injector;
+
 private:
     /**
      * Get the C64 model for the current loaded tune.
@@ -113,6 +155,11 @@ private:
      */
     void initialise();
 
+    /**
+     * Copy the play call summary to the engine info.
+     */
+    void updatePlayTime();
+
     /**
      * Release the SID builders.
      */
@@ -167,6 +214,44 @@ public:
 
     void debug(const bool enable, FILE *out) { m_c64.debug(enable, out); }
 
+    void trace(FILE *out);
+
+    void profile(bool enable);
+
+    bool getProfile(std::vector<ProfileEntry> &instructions, std::vector<ProfileEntry> &calls) const;
+
+    bool dumpProfile(FILE *out) const;
+
+    void getPlayCycles(std::vector<uint_least32_t> &frames) { m_playTime.getFrames(frames); }
+
+    void cpuTrace(unsigned int records);
+
+    bool getCpuTrace(std::vector<CpuTraceRecord> &records) const;
+
+    bool dumpCpuTrace(FILE *out) const;
+
+    bool addWatch(uint_least16_t start, uint_least16_t end, unsigned int access);
+
+    void clearWatches() { m_c64.clearWatches(); }
+
+    void getWatchHits(std::vector<WatchHit> &hits) { m_c64.getWatchHits(hits); }
+
+    void saveRam(unsigned int slot);
+
+    bool restoreRam(unsigned int slot);
+
+    bool getRamSnapshot(unsigned int slot, uint8_t* buffer) const;
+
+    void clearRamSnapshots() { m_ramSnapshots.clear(); }
+
+    void setSidWriteSink(SidWriteSink *sink);
+
+    void captureOnly(bool enable) { m_captureOnly = enable; }
+
+    bool sidLog(FILE *out);
+
+    uint_least32_t inject(const SidWrite *writes, unsigned int count, short *buffer, uint_least32_t samples);
+
     void mute(unsigned int sidNum, unsigned int voice, bool enable);
 
     const char *error() const { return m_errorString; }
@@ -176,6 +261,8 @@ public:
     EventContext *getEventScheduler() { return m_c64.getEventScheduler(); }
 
     uint_least16_t getCia1TimerA() const { return m_c64.getCia1TimerA(); }
+
+    bool getEventStats(std::vector<EventStats> &stats) const;
 };
 
 }
@@ -0,0 +1,80 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2015 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "playtime.h"
+
+namespace libsidplayfp
+{
+
+PlayTime::PlayTime(const EventContext &context) :
+    m_context(context)
+{
+    reset();
+}
+
+void PlayTime::reset()
+{
+    m_frames.clear();
+    m_start = 0;
+    m_sp = -1;
+    m_count = 0;
+    m_total = 0;
+    m_min = 0;
+    m_max = 0;
+}
+
+void PlayTime::interrupt(uint8_t sp)
+{
+    // Nested interrupt
+    if (m_sp >= 0 && sp < m_sp)
+        return;
+
+    m_start = m_context.getTime(EVENT_CLOCK_PHI2);
+    m_sp = sp;
+}
+
+void PlayTime::rti(uint8_t sp)
+{
+    // Returning from a nested interrupt
+    if (m_sp < 0 || sp < m_sp)
+        return;
+
+    m_sp = -1;
+
+    const uint_least32_t cycles = static_cast<uint_least32_t>(m_context.getTime(EVENT_CLOCK_PHI2) - m_start);
+
+    if (m_count == 0 || cycles < m_min)
+        m_min = cycles;
+    if (cycles > m_max)
+        m_max = cycles;
+    m_total += cycles;
+    m_count++;
+
+    if (m_frames.size() < MAX_FRAMES)
+        m_frames.push_back(cycles);
+}
+
+void PlayTime::getFrames(std::vector<uint_least32_t> &frames)
+{
+    frames.clear();
+    frames.swap(m_frames);
+}
+
+}
@@ -0,0 +1,121 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2015 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef PLAYTIME_H
+#define PLAYTIME_H
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "sidplayfp/event.h"
+
+namespace libsidplayfp
+{
+
+/**
+ * Measures the CPU cycles taken by each interrupt driven play call,
+ * from the start of the interrupt sequence to the end of
+ * the RTI returning to the interrupted code.
+ * For PSID tunes this includes the few cycles of the driver
+ * calling the play routine.
+ *
+ * Nested interrupts are accounted to the outer one.
+ * The stack pointer tells which RTI ends the handler, a handler
+ * which leaves without RTI is dropped when the next one starts.
+ *
+ * The CPU only calls it on interrupts and RTIs so it can be left
+ * enabled during normal playback.
+ */
+class PlayTime
+{
+public:
+    /// Maximum number of frames kept until they are fetched
+    static const unsigned int MAX_FRAMES = 65536;
+
+private:
+    const EventContext &m_context;
+
+    /// Cycles of the completed frames not yet fetched
+    std::vector<uint_least32_t> m_frames;
+
+    /// Time of the start of the running handler
+    event_clock_t m_start;
+
+    /// Stack pointer before the interrupt, -1 if no handler is running
+    int m_sp;
+
+    /// Number of completed frames
+    uint_least32_t m_count;
+
+    /// Total cycles of the completed frames
+    uint_least64_t m_total;
+
+    /// Shortest frame
+    uint_least32_t m_min;
+
+    /// Longest frame
+    uint_least32_t m_max;
+
+public:
+    PlayTime(const EventContext &context);
+
+    /**
+     * Forget the running handler and the collected data.
+     */
+    void reset();
+
+    /**
+     * The CPU has started an interrupt sequence.
+     *
+     * @param sp the stack pointer before the interrupt
+     */
+    void interrupt(uint8_t sp);
+
+    /**
+     * The CPU has executed an RTI.
+     *
+     * @param sp the stack pointer after the RTI
+     */
+    void rti(uint8_t sp);
+
+    /**
+     * Get the frames completed since the previous call.
+     *
+     * @param frames the vector to fill with the cycles of each frame
+     */
+    void getFrames(std::vector<uint_least32_t> &frames);
+
+    /// Number of completed frames
+    uint_least32_t count() const { return m_count; }
+
+    /// Shortest frame in cycles, 0 if none
+    uint_least32_t minCycles() const { return m_count ? m_min : 0; }
+
+    /// Longest frame in cycles
+    uint_least32_t maxCycles() const { return m_max; }
+
+    /// Average frame in cycles, 0 if none
+    uint_least32_t avgCycles() const { return m_count ? static_cast<uint_least32_t>(m_total / m_count) : 0; }
+};
+
+}
+
+#endif // PLAYTIME_H
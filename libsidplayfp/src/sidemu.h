@@ -24,6 +24,7 @@
 #define SIDEMU_H
 
 #include <string>
+#include <algorithm>
 
 #include "sidplayfp/SidConfig.h"
 #include "sidplayfp/siddefs.h"
@@ -43,11 +44,16 @@ class sidemu : public libsidplayfp::c64sid
 {
 public:
     /**
-     * Buffer size. 5000 is roughly 5 ms at 96 kHz
+     * Size of the output ring buffer, must be a power of 2.
+     * The samples must be consumed often enough that
+     * the ring never gets more than half full.
+     * The buffer is allocated twice as large so that
+     * a single clock call can write past the end of the ring,
+     * see #wrapBuffer.
      */
     enum
     {
-        OUTPUTBUFFERSIZE = 5000
+        OUTPUTBUFFERSIZE = 8192
     };
 
 private:
@@ -74,6 +80,20 @@ protected:
 
     std::string m_error;
 
+protected:
+    /**
+     * Move the samples written past the end
+     * of the ring back to its start.
+     */
+    void wrapBuffer()
+    {
+        if (m_bufferpos >= OUTPUTBUFFERSIZE)
+        {
+            m_bufferpos -= OUTPUTBUFFERSIZE;
+            std::copy(m_buffer + OUTPUTBUFFERSIZE, m_buffer + OUTPUTBUFFERSIZE + m_bufferpos, m_buffer);
+        }
+    }
+
 public:
     sidemu(sidbuilder *builder) :
         m_builder(builder),
@@ -0,0 +1,77 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2015 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "sidinjector.h"
+
+#include <vector>
+
+namespace libsidplayfp
+{
+
+bool SidInjector::config(const SidConfig &cfg)
+{
+    std::vector<SidConfig::sid_model_t> models(1, cfg.defaultSidModel);
+    if (cfg.secondSidAddress != 0)
+        models.push_back(cfg.defaultSidModel);
+    if (cfg.thirdSidAddress != 0)
+        models.push_back(cfg.defaultSidModel);
+
+    m_queue.clear();
+
+    if (!createChips(cfg, cfg.defaultC64Model, models))
+        return false;
+
+    resetChips();
+    m_mixer.resetBufs();
+    return true;
+}
+
+void SidInjector::clear()
+{
+    release();
+    m_queue.clear();
+}
+
+void SidInjector::inject(const SidWrite *writes, unsigned int count)
+{
+    m_queue.insert(m_queue.end(), writes, writes + count);
+}
+
+void SidInjector::run(unsigned int cycles)
+{
+    const event_clock_t end = m_context.getTime(EVENT_CLOCK_PHI1) + cycles;
+
+    // A write at PHI2 of a cycle reaches the chip at the next PHI1
+    while (!m_queue.empty() && m_queue.front().time + 1 <= end)
+    {
+        const SidWrite &w = m_queue.front();
+
+        // Late writes are applied right away
+        if (w.time + 1 > m_context.getTime(EVENT_CLOCK_PHI1))
+            m_context.run(w.time + 1);
+
+        poke(w.chip, w.reg & 0x1f, w.value);
+        m_queue.pop_front();
+    }
+
+    m_context.run(end);
+}
+
+}
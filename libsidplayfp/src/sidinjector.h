@@ -0,0 +1,86 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2015 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef SIDINJECTOR_H
+#define SIDINJECTOR_H
+
+#include <stdint.h>
+
+#include <deque>
+
+#include "sidplayfp/SidConfig.h"
+#include "sidplayfp/sidwrite.h"
+
+#include "sidrenderer.h"
+
+#include "sidcxx11.h"
+
+namespace libsidplayfp
+{
+
+/**
+ * Renderer of the SID register writes coming
+ * from outside the emulation.
+ *
+ * The writes are queued and applied while rendering,
+ * stamped like the captured ones so that a capture
+ * can be injected back with the same timing.
+ */
+class SidInjector : public SidRenderer
+{
+private:
+    /// Writes not reached yet, in time order
+    std::deque<SidWrite> m_queue;
+
+protected:
+    void run(unsigned int cycles) override;
+
+public:
+    /**
+     * Lock the chips, one plus one for each extra SID address
+     * configured, and restart the time from 0.
+     *
+     * @param cfg the configuration
+     * @return false on error
+     */
+    bool config(const SidConfig &cfg);
+
+    /**
+     * Unlock the chips and drop the queued writes.
+     */
+    void clear();
+
+    /**
+     * Check if the chips are locked.
+     */
+    bool configured() const { return !m_chips.empty(); }
+
+    /**
+     * Queue writes.
+     *
+     * @param writes the writes, in time order
+     * @param count the number of writes
+     */
+    void inject(const SidWrite *writes, unsigned int count);
+};
+
+}
+
+#endif // SIDINJECTOR_H
@@ -0,0 +1,79 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2015 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "sidlogwriter.h"
+
+#include <cstring>
+
+namespace libsidplayfp
+{
+
+/// Chip number of the control records
+const uint8_t CONTROL_CHIP = 3;
+
+/// Control record resetting the chips
+const uint8_t CONTROL_RESET = 0;
+
+SidLogWriter::SidLogWriter(FILE *out, const SidLogHeader &header) :
+    m_out(out),
+    m_last(0),
+    m_failed(false)
+{
+    SidLogHeader h = header;
+    memcpy(h.magic, "SIDWRLOG", sizeof(h.magic));
+    h.version = 1;
+    memset(h.reserved, 0, sizeof(h.reserved));
+
+    m_failed = fwrite(&h, sizeof(h), 1, m_out) != 1;
+}
+
+void SidLogWriter::record(uint8_t token, event_clock_t time)
+{
+    putc(token, m_out);
+
+    uint_least64_t delta = time - m_last;
+    while (delta >= 0x80)
+    {
+        putc(static_cast<int>(delta & 0x7f) | 0x80, m_out);
+        delta >>= 7;
+    }
+    putc(static_cast<int>(delta), m_out);
+
+    m_last = time;
+}
+
+void SidLogWriter::write(const SidWrite &w)
+{
+    record(static_cast<uint8_t>(w.chip << 5 | (w.reg & 0x1f)), w.time);
+
+    if (putc(w.value, m_out) == EOF)
+        m_failed = true;
+}
+
+void SidLogWriter::reset(event_clock_t time)
+{
+    record(CONTROL_CHIP << 5 | CONTROL_RESET, time);
+    m_last = 0;
+
+    if (ferror(m_out))
+        m_failed = true;
+}
+
+}
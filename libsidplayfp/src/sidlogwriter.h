@@ -0,0 +1,77 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2015 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef SIDLOGWRITER_H
+#define SIDLOGWRITER_H
+
+#include <stdint.h>
+#include <cstdio>
+
+#include "sidplayfp/sidlog.h"
+#include "sidplayfp/sidwrite.h"
+
+namespace libsidplayfp
+{
+
+/**
+ * Writes the SID register writes to a binary log,
+ * see SidLogHeader for the format.
+ */
+class SidLogWriter : public SidWriteSink
+{
+private:
+    FILE *m_out;
+
+    /// Time of the previous record
+    event_clock_t m_last;
+
+    bool m_failed;
+
+private:
+    void record(uint8_t token, event_clock_t time);
+
+public:
+    /**
+     * Start a log.
+     *
+     * @param out the file where to write the log
+     * @param header the header, the magic and version are filled in
+     */
+    SidLogWriter(FILE *out, const SidLogHeader &header);
+
+    virtual void write(const SidWrite &w);
+
+    /**
+     * Record a reset of the machine, after which
+     * the time restarts from 0.
+     *
+     * @param time the time of the reset
+     */
+    void reset(event_clock_t time);
+
+    /**
+     * Check for write errors.
+     */
+    bool failed() const { return m_failed; }
+};
+
+}
+
+#endif // SIDLOGWRITER_H
@@ -70,6 +70,14 @@ public:
     const char *chargenDesc() const { return getChargenDesc(); }
     //@}
 
+    /// CPU cycles of the interrupt driven play calls since the start of the song
+    //@{
+    uint_least32_t playCalls() const { return getPlayCalls(); }
+    uint_least32_t playCyclesMin() const { return getPlayCyclesMin(); }
+    uint_least32_t playCyclesAvg() const { return getPlayCyclesAvg(); }
+    uint_least32_t playCyclesMax() const { return getPlayCyclesMax(); }
+    //@}
+
 private:
     virtual const char *getName() const =0;
 
@@ -92,6 +100,11 @@ private:
     virtual const char *getBasicDesc() const =0;
     virtual const char *getChargenDesc() const =0;
 
+    virtual uint_least32_t getPlayCalls() const =0;
+    virtual uint_least32_t getPlayCyclesMin() const =0;
+    virtual uint_least32_t getPlayCyclesAvg() const =0;
+    virtual uint_least32_t getPlayCyclesMax() const =0;
+
 protected:
     ~SidInfo() {}
 };
@@ -0,0 +1,66 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2015 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "SidLogPlayer.h"
+
+#include "sidreplay.h"
+
+SidLogPlayer::SidLogPlayer() :
+    replay(*(new libsidplayfp::SidReplay)) {}
+
+SidLogPlayer::~SidLogPlayer()
+{
+    delete &replay;
+}
+
+bool SidLogPlayer::load(const char *filename)
+{
+    return replay.load(filename);
+}
+
+const SidLogHeader &SidLogPlayer::header() const
+{
+    return replay.header();
+}
+
+bool SidLogPlayer::config(const SidConfig &cfg)
+{
+    return replay.config(cfg);
+}
+
+uint_least32_t SidLogPlayer::play(short *buffer, uint_least32_t count)
+{
+    return replay.play(buffer, count);
+}
+
+bool SidLogPlayer::finished() const
+{
+    return replay.finished();
+}
+
+uint_least32_t SidLogPlayer::time() const
+{
+    return replay.time();
+}
+
+const char *SidLogPlayer::error() const
+{
+    return replay.error();
+}
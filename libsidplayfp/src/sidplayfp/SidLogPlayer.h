@@ -0,0 +1,103 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2015 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef SIDLOGPLAYER_H
+#define SIDLOGPLAYER_H
+
+#include <stdint.h>
+
+#include "sidplayfp/siddefs.h"
+#include "sidplayfp/sidlog.h"
+
+class SidConfig;
+
+// Private replay
+namespace libsidplayfp
+{
+    class SidReplay;
+}
+
+/**
+ * Player of the SID write logs.
+ *
+ * The logged writes are fed straight to the chip emulations
+ * without emulating the C64, so a tune can be rendered again
+ * with other chip models or filter settings at the cost
+ * of the SID emulation alone.
+ */
+class SID_EXTERN SidLogPlayer
+{
+private:
+    libsidplayfp::SidReplay &replay;
+
+public:
+    SidLogPlayer();
+    ~SidLogPlayer();
+
+    /**
+     * Load a log.
+     *
+     * @param filename the log file.
+     * @return false on errors.
+     */
+    bool load(const char *filename);
+
+    /**
+     * Get the header of the loaded log.
+     */
+    const SidLogHeader &header() const;
+
+    /**
+     * Configure the replay and restart it.
+     * The emulation, the sampling and the mixing settings are used,
+     * the chip and C64 models are taken from the log unless forced.
+     *
+     * @param cfg the configuration.
+     * @return false on errors.
+     */
+    bool config(const SidConfig &cfg);
+
+    /**
+     * Produce samples.
+     * After the end of the log the chips keep running with no writes.
+     *
+     * @param buffer the buffer to fill.
+     * @param count the number of samples.
+     * @return the number of produced samples.
+     */
+    uint_least32_t play(short *buffer, uint_least32_t count);
+
+    /**
+     * Check if all the logged writes have been played.
+     */
+    bool finished() const;
+
+    /**
+     * Get the time played in seconds.
+     */
+    uint_least32_t time() const;
+
+    /**
+     * Get the last error message.
+     */
+    const char *error() const;
+};
+
+#endif // SIDLOGPLAYER_H
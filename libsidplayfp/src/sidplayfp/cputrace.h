@@ -0,0 +1,103 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2015 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef CPUTRACE_H
+#define CPUTRACE_H
+
+#include <stdint.h>
+
+/**
+ * Binary CPU trace record, describing the state
+ * after the execution of an instruction.
+ */
+struct CpuTraceRecord
+{
+    /// The IRQ line was asserted.
+    static const uint8_t IRQ_ASSERTED = 0x01;
+
+    /// An interrupt sequence is starting after the instruction.
+    static const uint8_t INTERRUPT = 0x02;
+
+    /// The CPU has jammed on the instruction.
+    static const uint8_t JAM = 0x04;
+
+    /// PHI2 cycle of the record, truncated to 32 bits.
+    uint32_t time;
+
+    /// Address of the instruction.
+    uint16_t pc;
+
+    /// Operand of the instruction.
+    uint16_t operand;
+
+    /// Effective address.
+    uint16_t address;
+
+    /// Opcode.
+    uint8_t opcode;
+
+    /// Data read or written.
+    uint8_t data;
+
+    /// Registers
+    //@{
+    uint8_t a;
+    uint8_t x;
+    uint8_t y;
+    uint8_t sp;
+    //@}
+
+    /// Status register as NV1BDIZC.
+    uint8_t status;
+
+    /// Processor port direction and data registers.
+    //@{
+    uint8_t ddr;
+    uint8_t pr;
+    //@}
+
+    /// Combination of IRQ_ASSERTED, INTERRUPT and JAM.
+    uint8_t flags;
+};
+
+/**
+ * Header of a binary CPU trace file, followed by the records
+ * from the oldest to the newest, in host byte order.
+ */
+struct CpuTraceHeader
+{
+    /// "SIDCPUTR"
+    char magic[8];
+
+    /// Format version, currently 1.
+    uint32_t version;
+
+    /// Size of each record in bytes.
+    uint32_t recordSize;
+
+    /// Total records written since tracing was enabled,
+    /// the file contains the last ones.
+    uint64_t written;
+
+    /// Number of records.
+    uint32_t records;
+};
+
+#endif // CPUTRACE_H
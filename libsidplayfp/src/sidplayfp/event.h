@@ -52,10 +52,18 @@ class SID_EXTERN Event
     friend class EventScheduler;
 
 private:
-    /**
-     * The next event in sequence.
-     */
-    Event *next;
+    union
+    {
+        /**
+         * The next event in sequence.
+         */
+        Event *next;
+
+        /**
+         * Position in the queue of the heap based scheduler.
+         */
+        unsigned int heapPos;
+    };
 
     /**
      * The clock this event fires.
@@ -76,6 +84,7 @@ public:
      * @param name Descriptive string of the event.
      */
     Event(const char * const name) :
+        next(0),
         m_name(name) {}
 
     /**
@@ -89,6 +98,31 @@ protected:
     ~Event() {}
 };
 
+/**
+ * Event scheduler statistics for a kind of event,
+ * identified by its name.
+ */
+struct EventStats
+{
+    /// Name of the event.
+    const char *name;
+
+    /// Times the event has been fired.
+    uint_least64_t dispatches;
+
+    /// Times the event has been scheduled.
+    uint_least64_t schedules;
+
+    /// Times the event has been scheduled again while still pending or firing.
+    uint_least64_t reschedules;
+
+    /// Times the event has been cancelled while pending.
+    uint_least64_t cancels;
+
+    /// Average number of pending events when the event is scheduled.
+    double queueDepth;
+};
+
 /**
  * Fast EventScheduler, which maintains a linked list of Events.
  * This scheduler takes neglible time even when it is used to
@@ -0,0 +1,42 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2015 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdint.h>
+
+/**
+ * CPU profile of an address, either an instruction
+ * or the entry point of a subroutine or interrupt handler.
+ */
+struct ProfileEntry
+{
+    /// The address.
+    uint_least16_t address;
+
+    /// Times the instruction has been executed or the routine has been called.
+    uint_least64_t count;
+
+    /// CPU cycles spent, including stalls and, for routines, the called ones.
+    uint_least64_t cycles;
+};
+
+#endif // PROFILE_H
@@ -0,0 +1,72 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2015 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef SIDLOG_H
+#define SIDLOG_H
+
+#include <stdint.h>
+
+/**
+ * Header of a binary SID write log.
+ *
+ * The header is followed by one record for each write,
+ * in time order, until the end of the file:
+ *
+ * - a token byte, with the register in bits 0-4 and
+ *   the chip in bits 5-6; bit 7 is reserved and must be 0.
+ *   Chip 3 marks a control record, register 0 being a reset
+ *   of all the chips at the record time, after which
+ *   the time restarts from 0;
+ * - the cycles elapsed since the previous record,
+ *   or since the start of the log, as an unsigned LEB128 number:
+ *   7 bits per byte, least significant first, bit 7 set
+ *   in all the bytes but the last;
+ * - the written value, absent in control records.
+ *
+ * The time of a write is the PHI2 cycle of the CPU access.
+ * At the start of the log and after each reset the chips are
+ * reset and their volume is set to 0xf, as the PSID driver expects.
+ *
+ * Most writes take three bytes and the logs compress well.
+ */
+struct SidLogHeader
+{
+    /// "SIDWRLOG"
+    char magic[8];
+
+    /// Format version, currently 1.
+    uint8_t version;
+
+    /// Number of chips, 1 to 3.
+    uint8_t chips;
+
+    /// C64 model giving the clock, as SidConfig::c64_model_t:
+    /// 0 PAL, 1 NTSC, 2 old NTSC, 3 Drean.
+    uint8_t clock;
+
+    /// Model of each chip, as SidConfig::sid_model_t:
+    /// 0 MOS6581, 1 MOS8580.
+    uint8_t models[3];
+
+    /// Reserved, 0.
+    uint8_t reserved[2];
+};
+
+#endif // SIDLOG_H
@@ -96,6 +96,101 @@ void sidplayfp::debug(bool enable, FILE *out)
     sidplayer.debug(enable, out);
 }
 
+void sidplayfp::trace(FILE *out)
+{
+    sidplayer.trace(out);
+}
+
+void sidplayfp::profile(bool enable)
+{
+    sidplayer.profile(enable);
+}
+
+bool sidplayfp::getProfile(std::vector<ProfileEntry> &instructions, std::vector<ProfileEntry> &calls) const
+{
+    return sidplayer.getProfile(instructions, calls);
+}
+
+bool sidplayfp::dumpProfile(FILE *out) const
+{
+    return sidplayer.dumpProfile(out);
+}
+
+void sidplayfp::getPlayCycles(std::vector<uint_least32_t> &frames)
+{
+    sidplayer.getPlayCycles(frames);
+}
+
+void sidplayfp::cpuTrace(unsigned int records)
+{
+    sidplayer.cpuTrace(records);
+}
+
+bool sidplayfp::getCpuTrace(std::vector<CpuTraceRecord> &records) const
+{
+    return sidplayer.getCpuTrace(records);
+}
+
+bool sidplayfp::dumpCpuTrace(FILE *out) const
+{
+    return sidplayer.dumpCpuTrace(out);
+}
+
+bool sidplayfp::addWatch(uint_least16_t start, uint_least16_t end, unsigned int access)
+{
+    return sidplayer.addWatch(start, end, access);
+}
+
+void sidplayfp::clearWatches()
+{
+    sidplayer.clearWatches();
+}
+
+void sidplayfp::getWatchHits(std::vector<WatchHit> &hits)
+{
+    sidplayer.getWatchHits(hits);
+}
+
+void sidplayfp::saveRam(unsigned int slot)
+{
+    sidplayer.saveRam(slot);
+}
+
+bool sidplayfp::restoreRam(unsigned int slot)
+{
+    return sidplayer.restoreRam(slot);
+}
+
+bool sidplayfp::getRamSnapshot(unsigned int slot, uint8_t* buffer) const
+{
+    return sidplayer.getRamSnapshot(slot, buffer);
+}
+
+void sidplayfp::clearRamSnapshots()
+{
+    sidplayer.clearRamSnapshots();
+}
+
+void sidplayfp::setSidWriteSink(SidWriteSink *sink)
+{
+    sidplayer.setSidWriteSink(sink);
+}
+
+void sidplayfp::captureOnly(bool enable)
+{
+    sidplayer.captureOnly(enable);
+}
+
+bool sidplayfp::sidLog(FILE *out)
+{
+    return sidplayer.sidLog(out);
+}
+
+uint_least32_t sidplayfp::inject(const SidWrite *writes, unsigned int count, short *buffer, uint_least32_t samples)
+{
+    return sidplayer.inject(writes, count, buffer, samples);
+}
+
 bool sidplayfp::isPlaying() const
 {
     return sidplayer.isPlaying();
@@ -115,3 +210,8 @@ uint_least16_t sidplayfp::getCia1TimerA() const
 {
     return sidplayer.getCia1TimerA();
 }
+
+bool sidplayfp::getEventStats(std::vector<EventStats> &stats) const
+{
+    return sidplayer.getEventStats(stats);
+}
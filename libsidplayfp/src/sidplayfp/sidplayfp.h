@@ -26,8 +26,15 @@
 #include <stdint.h>
 #include <stdio.h>
 
+#include <vector>
+
 #include "sidplayfp/siddefs.h"
 #include "sidplayfp/sidversion.h"
+#include "sidplayfp/event.h"
+#include "sidplayfp/profile.h"
+#include "sidplayfp/cputrace.h"
+#include "sidplayfp/watch.h"
+#include "sidplayfp/sidwrite.h"
 
 class  SidConfig;
 class  SidTune;
@@ -127,6 +134,199 @@ public:
      */
     void debug(bool enable, FILE *out);
 
+    /**
+     * Write a timeline of the emulation in the Chrome trace event format,
+     * which can be loaded in chrome://tracing or Perfetto.
+     * Scheduler events, CPU instructions, SID register writes
+     * and mixer calls are traced, with timestamps in C64 cycles.
+     *
+     * @param out the file where to write the trace, NULL to stop tracing.
+     */
+    void trace(FILE *out);
+
+    /**
+     * Profile the code run by the CPU, counting executions and cycles
+     * for each instruction and calls and inclusive cycles
+     * for each subroutine and interrupt handler.
+     * Enabling the profiler clears the collected data.
+     *
+     * @param enable true to enable the profiler, false to disable it.
+     */
+    void profile(bool enable);
+
+    /**
+     * Get the CPU profile, sorted by decreasing cycles.
+     *
+     * @param instructions the vector to fill with the instruction profile.
+     * @param calls the vector to fill with the routine profile.
+     * @return true if the profiler is enabled, false otherwise.
+     */
+    bool getProfile(std::vector<ProfileEntry> &instructions, std::vector<ProfileEntry> &calls) const;
+
+    /**
+     * Write the CPU profile as text, telling for each address
+     * whether it belongs to the tune, to the PSID driver or to the ROMs.
+     *
+     * @param out the file where to write the profile.
+     * @return true if the profiler is enabled and a tune is loaded, false otherwise.
+     */
+    bool dumpProfile(FILE *out) const;
+
+    /**
+     * Get the CPU cycles taken by each interrupt driven play call
+     * completed since the previous call, measured from the start
+     * of the interrupt to the end of the RTI.
+     * Up to 65536 calls are kept, the following ones are only
+     * accounted in the summary available through SidInfo.
+     *
+     * @param frames the vector to fill with the cycles of each play call.
+     */
+    void getPlayCycles(std::vector<uint_least32_t> &frames);
+
+    /**
+     * Keep a binary trace of the last executed CPU instructions
+     * in a fixed size ring buffer, to capture the lead-up
+     * to a crash or a JAM at a low cost.
+     * Each record takes 20 bytes.
+     *
+     * @param records the number of instructions to keep, 0 to stop tracing.
+     */
+    void cpuTrace(unsigned int records);
+
+    /**
+     * Get the kept CPU trace records, from the oldest to the newest.
+     * May be called from another thread while playing.
+     *
+     * @param records the vector to fill.
+     * @return true if CPU tracing is enabled, false otherwise.
+     */
+    bool getCpuTrace(std::vector<CpuTraceRecord> &records) const;
+
+    /**
+     * Write the kept CPU trace records to a binary file,
+     * which the cpudecode tool turns into text.
+     *
+     * @param out the file where to write.
+     * @return true on success, false if tracing is disabled or on write errors.
+     */
+    bool dumpCpuTrace(FILE *out) const;
+
+    /**
+     * Watch CPU accesses to an address range.
+     * Only the watched 4k areas are routed through the
+     * instrumented memory banks, with no cost for the others.
+     * Must not be called while playing.
+     *
+     * @param start the first address.
+     * @param end the last address.
+     * @param access combination of the watch_access_t values.
+     * @return false if the range or the access is invalid.
+     */
+    bool addWatch(uint_least16_t start, uint_least16_t end, unsigned int access);
+
+    /**
+     * Remove all watches and the pending hits.
+     * Must not be called while playing.
+     */
+    void clearWatches();
+
+    /**
+     * Get the watched accesses since the previous call.
+     * At most 65536 hits are kept in between.
+     *
+     * @param hits the vector to fill.
+     */
+    void getWatchHits(std::vector<WatchHit> &hits);
+
+    /**
+     * Save the C64 RAM in a snapshot slot.
+     * The RAM pages are shared copy-on-write with the running machine,
+     * so saving costs a walk of the page table plus a copy
+     * of each page written afterwards, cheap enough
+     * for frequent checkpoints while playing.
+     * Must not be called while playing.
+     *
+     * @param slot the slot number, any previous snapshot in it is replaced.
+     */
+    void saveRam(unsigned int slot);
+
+    /**
+     * Restore the C64 RAM from a snapshot slot.
+     * The state of the CPU and of the other chips is not affected.
+     * Must not be called while playing.
+     *
+     * @param slot the slot number.
+     * @return false if the slot is empty.
+     */
+    bool restoreRam(unsigned int slot);
+
+    /**
+     * Get a copy of the RAM saved in a snapshot slot.
+     *
+     * @param slot the slot number.
+     * @param buffer the 64k buffer to fill.
+     * @return false if the slot is empty.
+     */
+    bool getRamSnapshot(unsigned int slot, uint8_t* buffer) const;
+
+    /**
+     * Drop all the RAM snapshots.
+     */
+    void clearRamSnapshots();
+
+    /**
+     * Pass the SID register writes, with their cycle
+     * and chip number, to a receiver.
+     *
+     * @param sink the receiver, NULL to stop capturing.
+     */
+    void setSidWriteSink(SidWriteSink *sink);
+
+    /**
+     * Replace the SID emulations with chips which do no synthesis,
+     * to extract the register writes many times faster than realtime.
+     * The play calls produce no samples and, as without emulation,
+     * each one runs the machine for a fixed number of cycles.
+     * Reading the voice 3 oscillator and envelope gives 0.
+     * Takes effect at the next load or config.
+     *
+     * @param enable true to replace the SID emulations.
+     */
+    void captureOnly(bool enable);
+
+    /**
+     * Log the SID register writes to a binary file,
+     * which SidLogPlayer can play back without emulating the C64.
+     * The header describes the chips and the clock of the
+     * loaded tune, so this must be called after loading it;
+     * while logging, config() and load() fail.
+     * Restarting the tune is logged as a reset.
+     *
+     * @param out the file where to write the log, NULL to stop logging.
+     * @return false if no tune is loaded or on write errors.
+     */
+    bool sidLog(FILE *out);
+
+    /**
+     * Render SID register writes coming from outside the emulation,
+     * such as a tracker or a network stream, bypassing the CPU
+     * and the C64 memory map.
+     * The chips are locked from the configured emulation on the first
+     * call, one plus one for each extra SID address configured, using
+     * the default SID and C64 models; configuring again restarts the time.
+     * Times are cycles since the first call, stamped as the captured
+     * writes so a capture can be injected back.
+     * Writes later than the rendered samples are kept for the next calls.
+     * No tune must be loaded.
+     *
+     * @param writes the writes in time order.
+     * @param count the number of writes, may be 0 to only render.
+     * @param buffer the buffer for the samples.
+     * @param samples the number of samples to render.
+     * @return the number of samples rendered, 0 on error.
+     */
+    uint_least32_t inject(const SidWrite *writes, unsigned int count, short *buffer, uint_least32_t samples);
+
     /**
      * Mute/unmute a SID channel.
      *
@@ -164,6 +364,16 @@ public:
      * Get the CIA 1 Timer A programmed value.
      */
     uint_least16_t getCia1TimerA() const;
+
+    /**
+     * Get the event scheduler statistics, one entry for each kind of event.
+     * Only available if library have been compiled
+     * with the --enable-event-stats option.
+     *
+     * @param stats the vector to fill with the statistics.
+     * @return true if statistics are available, false otherwise.
+     */
+    bool getEventStats(std::vector<EventStats> &stats) const;
 };
 
 #endif // SIDPLAYFP_H
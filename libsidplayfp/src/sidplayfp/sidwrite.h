@@ -0,0 +1,78 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2015 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef SIDWRITE_H
+#define SIDWRITE_H
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "sidplayfp/event.h"
+
+/**
+ * A write to a SID register.
+ */
+struct SidWrite
+{
+    /// PHI2 cycle of the write.
+    event_clock_t time;
+
+    /// SID chip, 0 for the first one, 1 for the second and 2 for the third.
+    uint8_t chip;
+
+    /// Register, 0 to 0x1f.
+    uint8_t reg;
+
+    /// Written value.
+    uint8_t value;
+};
+
+/**
+ * Receiver of the SID register writes.
+ */
+class SidWriteSink
+{
+public:
+    virtual ~SidWriteSink() {}
+
+    /**
+     * A SID register has been written.
+     * Called from the emulation while playing.
+     *
+     * @param w the write.
+     */
+    virtual void write(const SidWrite &w) = 0;
+};
+
+/**
+ * Sink collecting the SID register writes in a vector.
+ */
+class SidWriteBuffer : public SidWriteSink
+{
+public:
+    /// The collected writes, to be cleared by the caller.
+    std::vector<SidWrite> writes;
+
+public:
+    virtual void write(const SidWrite &w) { writes.push_back(w); }
+};
+
+#endif // SIDWRITE_H
@@ -0,0 +1,59 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2015 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef WATCH_H
+#define WATCH_H
+
+#include <stdint.h>
+
+#include "sidplayfp/event.h"
+
+/**
+ * Kinds of CPU accesses that can be watched, to be combined.
+ */
+enum watch_access_t
+{
+    WATCH_READ = 1,
+    WATCH_WRITE = 2,
+    WATCH_EXECUTE = 4
+};
+
+/**
+ * A watched CPU access.
+ */
+struct WatchHit
+{
+    /// PHI2 cycle of the access.
+    event_clock_t time;
+
+    /// Accessed address.
+    uint_least16_t address;
+
+    /// Address of the instruction doing the access.
+    uint_least16_t pc;
+
+    /// Value read or written, or the opcode for executions.
+    uint8_t value;
+
+    /// One of WATCH_READ, WATCH_WRITE or WATCH_EXECUTE.
+    uint8_t access;
+};
+
+#endif // WATCH_H
@@ -0,0 +1,192 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2015 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "sidrenderer.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "sidplayfp/sidbuilder.h"
+
+#include "sidemu.h"
+#include "c64/c64.h"
+
+namespace libsidplayfp
+{
+
+const char ERR_NA[]                 = "NA";
+const char ERR_NO_EMULATION[]       = "SIDRENDERER ERROR: No SID emulation.";
+const char ERR_UNSUPPORTED_FREQ[]   = "SIDRENDERER ERROR: Unsupported sampling frequency.";
+
+void RenderContext::reset()
+{
+    m_time = 0;
+    m_pending.clear();
+}
+
+void RenderContext::run(event_clock_t time)
+{
+    while (!m_pending.empty() && m_pending.front().time <= time)
+    {
+        const Pending p = m_pending.front();
+        m_pending.erase(m_pending.begin());
+        m_time = p.time;
+        p.event->event();
+    }
+    m_time = time;
+}
+
+void RenderContext::cancel(Event &event)
+{
+    for (std::vector<Pending>::iterator it = m_pending.begin(); it != m_pending.end(); ++it)
+    {
+        if (it->event == &event)
+        {
+            m_pending.erase(it);
+            return;
+        }
+    }
+}
+
+void RenderContext::schedule(Event &event, unsigned int cycles, event_phase_t)
+{
+    cancel(event);
+
+    // Events due at the same time fire in FIFO order
+    const Pending p = { m_time + cycles, &event };
+    std::vector<Pending>::iterator it = m_pending.begin();
+    while (it != m_pending.end() && it->time <= p.time)
+        ++it;
+    m_pending.insert(it, p);
+}
+
+bool RenderContext::isPending(Event &event) const
+{
+    for (std::vector<Pending>::const_iterator it = m_pending.begin(); it != m_pending.end(); ++it)
+    {
+        if (it->event == &event)
+            return true;
+    }
+    return false;
+}
+
+SidRenderer::SidRenderer() :
+    m_cpuFreq(0.),
+    m_errorString(ERR_NA) {}
+
+SidRenderer::~SidRenderer()
+{
+    release();
+}
+
+bool SidRenderer::createChips(const SidConfig &cfg, SidConfig::c64_model_t clock,
+                              const std::vector<SidConfig::sid_model_t> &models)
+{
+    if (cfg.sidEmulation == nullptr)
+    {
+        m_errorString = ERR_NO_EMULATION;
+        return false;
+    }
+    if (cfg.frequency < 8000)
+    {
+        m_errorString = ERR_UNSUPPORTED_FREQ;
+        return false;
+    }
+
+    release();
+
+    m_cpuFreq = c64::getCpuFreq(static_cast<c64::model_t>(clock));
+
+    for (std::vector<SidConfig::sid_model_t>::const_iterator it = models.begin(); it != models.end(); ++it)
+    {
+        sidemu *s = cfg.sidEmulation->lock(&m_context, *it);
+        if (!cfg.sidEmulation->getStatus())
+        {
+            m_errorString = cfg.sidEmulation->error();
+            release();
+            return false;
+        }
+
+        s->sampling(static_cast<float>(m_cpuFreq), cfg.frequency, cfg.samplingMethod, cfg.fastSampling);
+        m_chips.push_back(s);
+        m_mixer.addSid(s);
+    }
+
+    m_mixer.setStereo(cfg.playback == SidConfig::STEREO);
+    m_mixer.setVolume(cfg.leftVolume, cfg.rightVolume);
+
+    m_cfg = cfg;
+
+    return true;
+}
+
+void SidRenderer::release()
+{
+    for (std::vector<sidemu*>::iterator it = m_chips.begin(); it != m_chips.end(); ++it)
+    {
+        if (sidbuilder *b = (*it)->builder())
+            b->unlock(*it);
+    }
+    m_chips.clear();
+    m_mixer.clearSids();
+}
+
+void SidRenderer::resetChips()
+{
+    m_context.reset();
+
+    // As the PSID driver expects
+    for (std::vector<sidemu*>::iterator it = m_chips.begin(); it != m_chips.end(); ++it)
+        (*it)->reset(0xf);
+}
+
+void SidRenderer::poke(unsigned int chip, uint8_t reg, uint8_t value)
+{
+    if (chip < m_chips.size())
+        m_chips[chip]->poke(reg, value);
+}
+
+uint_least32_t SidRenderer::play(short *buffer, uint_least32_t count)
+{
+    if (m_chips.empty())
+        return 0;
+
+    m_mixer.begin(buffer, count);
+
+    const double cyclesPerSample = m_cpuFreq / m_cfg.frequency;
+
+    while (m_mixer.notFinished())
+    {
+        // Run just as long as needed to produce the missing samples,
+        // filling at most half of the chips' ring buffers
+        const uint_least32_t samples = std::min<uint_least32_t>(
+            m_mixer.samplesNeeded(), sidemu::OUTPUTBUFFERSIZE / 2);
+        const unsigned int cycles = static_cast<unsigned int>(samples * cyclesPerSample) + 1;
+
+        run(cycles);
+
+        m_mixer.clockChips();
+        m_mixer.doMix();
+    }
+
+    return m_mixer.samplesGenerated();
+}
+
+}
@@ -0,0 +1,167 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2015 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef SIDRENDERER_H
+#define SIDRENDERER_H
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "sidplayfp/event.h"
+#include "sidplayfp/SidConfig.h"
+
+#include "mixer.h"
+
+#include "sidcxx11.h"
+
+class sidemu;
+
+namespace libsidplayfp
+{
+
+/**
+ * Minimal event context for the rendering,
+ * a cycle counter with the few events
+ * the chip emulations may schedule.
+ */
+class RenderContext : public EventContext
+{
+private:
+    struct Pending
+    {
+        event_clock_t time;
+        Event *event;
+    };
+
+private:
+    /// Current cycle
+    event_clock_t m_time;
+
+    /// Pending events in time order
+    std::vector<Pending> m_pending;
+
+public:
+    RenderContext() :
+        m_time(0) {}
+
+    /**
+     * Restart the time from 0 and drop the pending events.
+     */
+    void reset();
+
+    /**
+     * Advance the time, firing the events due.
+     *
+     * @param time the cycle to reach
+     */
+    void run(event_clock_t time);
+
+    void cancel(Event &event) override;
+
+    void schedule(Event &event, unsigned int cycles, event_phase_t phase) override;
+
+    void schedule(Event &event, unsigned int cycles) override { schedule(event, cycles, EVENT_CLOCK_PHI1); }
+
+    bool isPending(Event &event) const override;
+
+    event_clock_t getTime(event_phase_t) const override { return m_time; }
+
+    event_clock_t getTime(event_clock_t clock, event_phase_t) const override { return m_time - clock; }
+
+    event_phase_t phase() const override { return EVENT_CLOCK_PHI1; }
+};
+
+/**
+ * Base of the players feeding SID register writes
+ * straight to the chip emulations without emulating the C64.
+ *
+ * Subclasses provide the writes by running the time forward.
+ */
+class SidRenderer
+{
+protected:
+    RenderContext m_context;
+
+    Mixer m_mixer;
+
+    std::vector<sidemu*> m_chips;
+
+    SidConfig m_cfg;
+
+    double m_cpuFreq;
+
+    const char *m_errorString;
+
+protected:
+    /**
+     * Lock the chips from the configured emulation
+     * and set up the sampling and the mixer.
+     *
+     * @param cfg the configuration
+     * @param clock the C64 model giving the clock
+     * @param models the models of the chips, one to three
+     * @return false on error
+     */
+    bool createChips(const SidConfig &cfg, SidConfig::c64_model_t clock,
+                     const std::vector<SidConfig::sid_model_t> &models);
+
+    /**
+     * Unlock the chips.
+     */
+    void release();
+
+    /**
+     * Restart the time from 0 and reset the chips.
+     */
+    void resetChips();
+
+    /**
+     * Write a register at the current time.
+     * Writes to missing chips are ignored.
+     */
+    void poke(unsigned int chip, uint8_t reg, uint8_t value);
+
+    /**
+     * Run the time forward, writing the registers due.
+     *
+     * @param cycles the cycles to run
+     */
+    virtual void run(unsigned int cycles) = 0;
+
+public:
+    SidRenderer();
+    virtual ~SidRenderer();
+
+    /**
+     * Render the samples.
+     *
+     * @param buffer the buffer for the samples
+     * @param count the number of samples to render
+     * @return the number of samples rendered
+     */
+    uint_least32_t play(short *buffer, uint_least32_t count);
+
+    const char *error() const { return m_errorString; }
+};
+
+}
+
+#endif // SIDRENDERER_H
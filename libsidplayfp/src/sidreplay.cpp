@@ -0,0 +1,193 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2015 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "sidreplay.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace libsidplayfp
+{
+
+const char ERR_CANT_OPEN[]          = "SIDREPLAY ERROR: Can't open the log.";
+const char ERR_BAD_LOG[]            = "SIDREPLAY ERROR: Not a SID write log or unsupported version.";
+const char ERR_NO_LOG[]             = "SIDREPLAY ERROR: No log loaded.";
+
+/// Chip number of the control records
+const uint8_t CONTROL_CHIP = 3;
+
+/// Control record resetting the chips
+const uint8_t CONTROL_RESET = 0;
+
+SidReplay::SidReplay() :
+    m_pos(0),
+    m_pending(false),
+    m_recordTime(0),
+    m_token(0),
+    m_value(0),
+    m_elapsed(0)
+{
+    memset(&m_header, 0, sizeof(m_header));
+}
+
+bool SidReplay::load(const char *filename)
+{
+    release();
+    m_log.clear();
+    m_pending = false;
+
+    FILE *in = fopen(filename, "rb");
+    if (in == nullptr)
+    {
+        m_errorString = ERR_CANT_OPEN;
+        return false;
+    }
+
+    uint8_t buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), in)) > 0)
+        m_log.insert(m_log.end(), buffer, buffer + n);
+    fclose(in);
+
+    if (m_log.size() < sizeof(SidLogHeader))
+    {
+        m_errorString = ERR_BAD_LOG;
+        return false;
+    }
+
+    memcpy(&m_header, &m_log[0], sizeof(m_header));
+    if (memcmp(m_header.magic, "SIDWRLOG", sizeof(m_header.magic)) != 0
+        || m_header.version != 1
+        || m_header.chips < 1 || m_header.chips > 3
+        || m_header.clock > SidConfig::DREAN)
+    {
+        m_log.clear();
+        m_errorString = ERR_BAD_LOG;
+        return false;
+    }
+
+    return true;
+}
+
+bool SidReplay::config(const SidConfig &cfg)
+{
+    if (m_log.empty())
+    {
+        m_errorString = ERR_NO_LOG;
+        return false;
+    }
+
+    // The forced settings override the logged ones
+    const SidConfig::c64_model_t clock = cfg.forceC64Model ? cfg.defaultC64Model
+        : static_cast<SidConfig::c64_model_t>(m_header.clock);
+
+    std::vector<SidConfig::sid_model_t> models;
+    for (unsigned int i = 0; i < m_header.chips; i++)
+    {
+        models.push_back(cfg.forceSidModel ? cfg.defaultSidModel
+            : (m_header.models[i] != 0) ? SidConfig::MOS8580 : SidConfig::MOS6581);
+    }
+
+    if (!createChips(cfg, clock, models))
+        return false;
+
+    rewind();
+    return true;
+}
+
+void SidReplay::rewind()
+{
+    m_pos = sizeof(SidLogHeader);
+    m_recordTime = 0;
+    m_elapsed = 0;
+    resetChips();
+    m_mixer.resetBufs();
+    nextRecord();
+}
+
+void SidReplay::nextRecord()
+{
+    m_pending = false;
+
+    if (m_pos >= m_log.size())
+        return;
+
+    const uint8_t token = m_log[m_pos++];
+
+    uint_least64_t delta = 0;
+    unsigned int shift = 0;
+    uint8_t byte;
+    do
+    {
+        if (m_pos >= m_log.size())
+            return;
+        byte = m_log[m_pos++];
+        delta |= static_cast<uint_least64_t>(byte & 0x7f) << shift;
+        shift += 7;
+    }
+    while ((byte & 0x80) && shift < 64);
+
+    if ((token >> 5) != CONTROL_CHIP)
+    {
+        if (m_pos >= m_log.size())
+            return;
+        m_value = m_log[m_pos++];
+    }
+
+    m_token = token;
+    m_recordTime += delta;
+    m_pending = true;
+}
+
+void SidReplay::run(unsigned int cycles)
+{
+    event_clock_t end = m_context.getTime(EVENT_CLOCK_PHI1) + cycles;
+    m_elapsed += cycles;
+
+    // A write at PHI2 of a cycle reaches the chip at the next PHI1
+    while (m_pending && m_recordTime + 1 <= end)
+    {
+        m_context.run(m_recordTime + 1);
+
+        const unsigned int chip = (m_token >> 5) & 3;
+        if (chip != CONTROL_CHIP)
+        {
+            poke(chip, m_token & 0x1f, m_value);
+        }
+        else if ((m_token & 0x1f) == CONTROL_RESET)
+        {
+            // The time restarts from 0
+            end -= m_context.getTime(EVENT_CLOCK_PHI1);
+            m_recordTime = 0;
+            resetChips();
+        }
+
+        nextRecord();
+    }
+
+    m_context.run(end);
+}
+
+uint_least32_t SidReplay::time() const
+{
+    return m_cpuFreq > 0. ? static_cast<uint_least32_t>(m_elapsed / m_cpuFreq) : 0;
+}
+
+}
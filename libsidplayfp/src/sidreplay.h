@@ -0,0 +1,87 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2015 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef SIDREPLAY_H
+#define SIDREPLAY_H
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "sidplayfp/SidConfig.h"
+#include "sidplayfp/sidlog.h"
+
+#include "sidrenderer.h"
+
+#include "sidcxx11.h"
+
+namespace libsidplayfp
+{
+
+/**
+ * Player of the SID write logs.
+ */
+class SidReplay : public SidRenderer
+{
+private:
+    /// The log, header included
+    std::vector<uint8_t> m_log;
+
+    SidLogHeader m_header;
+
+    /// Position of the next record
+    size_t m_pos;
+
+    /// The next record
+    //@{
+    bool m_pending;
+    event_clock_t m_recordTime;
+    uint8_t m_token;
+    uint8_t m_value;
+    //@}
+
+    /// Cycles played since the start of the log
+    uint_least64_t m_elapsed;
+
+private:
+    void rewind();
+
+    void nextRecord();
+
+protected:
+    void run(unsigned int cycles) override;
+
+public:
+    SidReplay();
+
+    bool load(const char *filename);
+
+    const SidLogHeader &header() const { return m_header; }
+
+    bool config(const SidConfig &cfg);
+
+    bool finished() const { return !m_pending; }
+
+    uint_least32_t time() const;
+};
+
+}
+
+#endif // SIDREPLAY_H
@@ -0,0 +1,194 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2015 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+/*
+ * Playback benchmark.
+ *
+ * Renders each tune for the given amount of time and reports the
+ * emulation speed together with a checksum of the produced audio,
+ * so that different builds (e.g. --enable-event-heap) can be compared
+ * both for speed and for bit-identical output.
+ *
+ * Build with "make test/bench", then run
+ *     test/bench [-t seconds] [-b buffer size] [-r] [-s] [-x socket] tune.sid ...
+ * where -r selects reSID instead of reSIDfp, -s clocks the reSIDfp
+ * voices together, with SSE2 where the build supports it
+ * and with a plain loop otherwise, and -x renders
+ * the chips with the SID server listening on the socket,
+ * see test/sidserver.cpp.
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <vector>
+
+#include "sidplayfp/sidplayfp.h"
+#include "sidplayfp/SidTune.h"
+#include "sidplayfp/SidConfig.h"
+#include "sidplayfp/event.h"
+#include "builders/residfp-builder/residfp.h"
+#include "builders/resid-builder/resid.h"
+#ifndef _WIN32
+#  include "builders/remote-builder/remote.h"
+#endif
+
+/*
+ * FNV-1a hash of the produced samples.
+ */
+uint_least32_t checksum(uint_least32_t hash, const short *buffer, uint_least32_t samples)
+{
+    for (uint_least32_t i = 0; i < samples; i++)
+    {
+        const unsigned int sample = static_cast<unsigned short>(buffer[i]);
+        hash = (hash ^ (sample & 0xff)) * 16777619u;
+        hash = (hash ^ (sample >> 8)) * 16777619u;
+    }
+    return hash;
+}
+
+double now()
+{
+    return static_cast<double>(clock()) / CLOCKS_PER_SEC;
+}
+
+int main(int argc, char* argv[])
+{
+    unsigned int seconds = 60;
+    unsigned int bufferSize = 4096;
+    bool useResid = false;
+    bool simd = false;
+    const char *server = 0;
+
+    int i = 1;
+    for (; i < argc && argv[i][0] == '-'; i++)
+    {
+        if (!strcmp(argv[i], "-t") && i + 1 < argc)
+            seconds = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-b") && i + 1 < argc)
+            bufferSize = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-r"))
+            useResid = true;
+        else if (!strcmp(argv[i], "-s"))
+            simd = true;
+#ifndef _WIN32
+        else if (!strcmp(argv[i], "-x") && i + 1 < argc)
+            server = argv[++i];
+#endif
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [-t seconds] [-b buffer size] [-r] [-s] [-x socket] tune.sid ..." << std::endl;
+            return -1;
+        }
+    }
+
+    std::auto_ptr<sidbuilder> builder;
+#ifndef _WIN32
+    if (server != 0)
+    {
+        RemoteBuilder *rs = new RemoteBuilder("Bench", server);
+        rs->create(3);
+        builder.reset(rs);
+    }
+    else
+#endif
+    if (useResid)
+    {
+        ReSIDBuilder *rs = new ReSIDBuilder("Bench");
+        rs->create(3);
+        builder.reset(rs);
+    }
+    else
+    {
+        ReSIDfpBuilder *rs = new ReSIDfpBuilder("Bench");
+        rs->create(3);
+        rs->simd(simd);
+        builder.reset(rs);
+
+        if (simd)
+            std::cout << "voices clocked with " << (ReSIDfpBuilder::simdVectorized() ? "SSE2" : "a plain loop") << std::endl;
+    }
+
+    if (!builder->getStatus())
+    {
+        std::cerr << builder->error() << std::endl;
+        return -1;
+    }
+
+    sidplayfp engine;
+
+    SidConfig cfg;
+    cfg.frequency = 44100;
+    cfg.samplingMethod = SidConfig::INTERPOLATE;
+    cfg.sidEmulation = builder.get();
+
+    std::vector<short> buffer(bufferSize);
+
+    double totalTime = 0.;
+    for (; i < argc; i++)
+    {
+        std::auto_ptr<SidTune> tune(new SidTune(argv[i]));
+        if (!tune->getStatus())
+        {
+            std::cerr << argv[i] << ": " << tune->statusString() << std::endl;
+            continue;
+        }
+
+        tune->selectSong(0);
+
+        if (!engine.config(cfg) || !engine.load(tune.get()))
+        {
+            std::cerr << argv[i] << ": " << engine.error() << std::endl;
+            continue;
+        }
+
+        const uint_least32_t samples = cfg.frequency * seconds;
+        uint_least32_t hash = 2166136261u;
+
+        const double start = now();
+        for (uint_least32_t played = 0; played < samples; )
+        {
+            const uint_least32_t n = engine.play(&buffer.front(), bufferSize);
+            if (n == 0)
+                break;
+            hash = checksum(hash, &buffer.front(), n);
+            played += n;
+        }
+        const double elapsed = now() - start;
+        totalTime += elapsed;
+
+        const event_clock_t cycles = engine.getEventContext()->getTime(EVENT_CLOCK_PHI1);
+
+        std::cout << std::hex << std::setw(8) << std::setfill('0') << hash << std::dec
+                  << std::fixed << std::setprecision(3)
+                  << "  " << elapsed << " s"
+                  << "  " << std::setprecision(1) << (seconds / elapsed) << "x"
+                  << "  " << std::setprecision(0) << (cycles / elapsed) << " cycles/s"
+                  << "  " << argv[i] << std::endl;
+    }
+
+    std::cout << std::fixed << std::setprecision(3) << "total " << totalTime << " s" << std::endl;
+
+    return 0;
+}
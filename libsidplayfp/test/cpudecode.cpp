@@ -0,0 +1,101 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2015 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+/*
+ * Binary CPU trace decoder.
+ *
+ * Turns a trace written by sidplayfp::dumpCpuTrace into the
+ * text format of the CPU debug dump.
+ *
+ * Build with "make test/cpudecode", then run
+ *     test/cpudecode trace.bin [output.txt]
+ */
+
+#include <cstdio>
+#include <cstring>
+
+#include "sidplayfp/cputrace.h"
+#include "c64/CPU/mos6510debug.h"
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2 || argc > 3)
+    {
+        fprintf(stderr, "Usage: %s trace.bin [output.txt]\n", argv[0]);
+        return 1;
+    }
+
+    FILE *in = fopen(argv[1], "rb");
+    if (in == NULL)
+    {
+        fprintf(stderr, "Cannot open %s\n", argv[1]);
+        return 1;
+    }
+
+    CpuTraceHeader header;
+    if (fread(&header, sizeof(header), 1, in) != 1
+        || memcmp(header.magic, "SIDCPUTR", sizeof(header.magic)) != 0)
+    {
+        fprintf(stderr, "%s is not a CPU trace\n", argv[1]);
+        fclose(in);
+        return 1;
+    }
+
+    if (header.version != 1 || header.recordSize != sizeof(CpuTraceRecord))
+    {
+        fprintf(stderr, "Unsupported trace version %u, record size %u\n",
+            static_cast<unsigned int>(header.version), static_cast<unsigned int>(header.recordSize));
+        fclose(in);
+        return 1;
+    }
+
+    FILE *out = stdout;
+    if (argc == 3)
+    {
+        out = fopen(argv[2], "w");
+        if (out == NULL)
+        {
+            fprintf(stderr, "Cannot create %s\n", argv[2]);
+            fclose(in);
+            return 1;
+        }
+    }
+
+    fprintf(out, "%u instructions of %llu\n\n",
+        static_cast<unsigned int>(header.records), static_cast<unsigned long long>(header.written));
+
+    int ret = 0;
+    CpuTraceRecord record;
+    for (uint32_t i = 0; i < header.records; i++)
+    {
+        if (fread(&record, sizeof(record), 1, in) != 1)
+        {
+            fprintf(stderr, "Truncated trace\n");
+            ret = 1;
+            break;
+        }
+        libsidplayfp::MOS6510Debug::DumpTrace(out, record);
+    }
+
+    if (out != stdout)
+        fclose(out);
+    fclose(in);
+    return ret;
+}
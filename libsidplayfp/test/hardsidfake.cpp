@@ -0,0 +1,268 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2015 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+/*
+ * Stand-in for the HardSID character device.
+ *
+ * Runs the packet queue of the HardSID builder against a FIFO
+ * read by a child process which decodes the packets as the device
+ * would, then checks that every write arrives at the right cycle
+ * and reports the write calls made and the time taken.
+ * A FIFO has no ioctls, so the delay ioctl is passed in the stream
+ * as a packet to the register $ff, which the device doesn't have.
+ *
+ * Build with "make test/hardsidfake", then run
+ *     test/hardsidfake [-l latency] [-n writes]
+ * where a latency of 0 sends each packet with its own write call
+ * as the builder did before the queue.
+ */
+
+#include <stdint.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+#include <string>
+#include <vector>
+
+#include "builders/hardsid-builder/hardsid-queue.h"
+
+#include "sidcxx11.h"
+
+/// Cycles played for each audio buffer, approx 4096 samples at 44.1kHz
+const event_clock_t BUFFER_CYCLES = 91500;
+
+/// Register of the packets standing for the delay ioctl
+const unsigned int DELAY_MARKER = 0xff;
+
+/*
+ * Queue sending the waits through the FIFO.
+ */
+class FakeQueue : public HardSIDQueue
+{
+protected:
+    void wait(unsigned int cycles) override
+    {
+        if (!flush())
+            return;
+
+        const unsigned int packet = (cycles << 16) | (DELAY_MARKER << 8);
+        if (::write(handle(), &packet, sizeof(packet)) != sizeof(packet))
+            fail();
+    }
+};
+
+/*
+ * Generator of a plausible write stream,
+ * bursts once per frame and some long silences.
+ */
+class Writes
+{
+private:
+    uint32_t m_seed;
+
+    unsigned int random(unsigned int range)
+    {
+        m_seed = m_seed * 1103515245u + 12345u;
+        return (m_seed >> 8) % range;
+    }
+
+public:
+    Writes() : m_seed(1) {}
+
+    void next(event_clock_t &gap, unsigned int &reg, unsigned int &data)
+    {
+        const unsigned int kind = random(100);
+        if (kind < 90)
+            gap = 4 + random(40);
+        else if (kind < 99)
+            gap = 15000 + random(5000);
+        else
+            gap = 60000 + random(300000);
+
+        reg = random(0x19);
+        data = random(0x100);
+    }
+};
+
+/*
+ * The device, check the packets against the expected writes.
+ */
+static int device(const char *path, unsigned int count)
+{
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        perror(path);
+        return 1;
+    }
+
+    Writes writes;
+    event_clock_t expected = 0;
+    event_clock_t time = 0;
+    unsigned int checked = 0;
+    unsigned long packets = 0;
+    unsigned int errors = 0;
+
+    std::vector<unsigned int> buffer(4096);
+    size_t pending = 0;
+    ssize_t n;
+    while ((n = read(fd, reinterpret_cast<char*>(&buffer[0]) + pending,
+                     buffer.size() * sizeof(unsigned int) - pending)) > 0)
+    {
+        pending += n;
+        const size_t words = pending / sizeof(unsigned int);
+        for (size_t i = 0; i < words; i++)
+        {
+            const unsigned int packet = buffer[i];
+            time += packet >> 16;
+            packets++;
+
+            // Delay ioctls
+            if (((packet >> 8) & 0xff) == DELAY_MARKER)
+                continue;
+
+            event_clock_t gap;
+            unsigned int reg;
+            unsigned int data;
+            writes.next(gap, reg, data);
+            expected += gap;
+
+            if (time != expected || ((packet >> 8) & 0xff) != reg || (packet & 0xff) != data)
+            {
+                if (errors++ < 10)
+                    fprintf(stderr, "write %u: got $%02x=$%02x at %llu, expected $%02x=$%02x at %llu\n",
+                        checked, (packet >> 8) & 0xff, packet & 0xff, (unsigned long long)time,
+                        reg, data, (unsigned long long)expected);
+            }
+            checked++;
+        }
+        pending -= words * sizeof(unsigned int);
+        memmove(&buffer[0], &buffer[words], pending);
+    }
+    close(fd);
+
+    printf("device: %u writes in %lu packets, %llu cycles, %u errors\n",
+        checked, packets, (unsigned long long)time, errors);
+
+    return (errors || checked != count) ? 1 : 0;
+}
+
+int main(int argc, char* argv[])
+{
+    unsigned int latency = HARDSID_LATENCY_CYCLES;
+    unsigned int count = 1000000;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "-l") && i + 1 < argc)
+            latency = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-n") && i + 1 < argc)
+            count = atoi(argv[++i]);
+        else
+        {
+            fprintf(stderr, "Usage: %s [-l latency] [-n writes]\n", argv[0]);
+            return -1;
+        }
+    }
+
+    char dir[] = "/tmp/hardsidXXXXXX";
+    if (mkdtemp(dir) == nullptr)
+    {
+        perror(argv[0]);
+        return -1;
+    }
+    const std::string path = std::string(dir) + "/sid0";
+    if (mkfifo(path.c_str(), 0600) < 0)
+    {
+        perror(argv[0]);
+        return -1;
+    }
+
+    const pid_t pid = fork();
+    if (pid == 0)
+    {
+        const int result = device(path.c_str(), count);
+        fflush(stdout);
+        _exit(result);
+    }
+
+    const int fd = open(path.c_str(), O_WRONLY);
+    if (fd < 0)
+    {
+        perror(path.c_str());
+        return -1;
+    }
+
+    FakeQueue queue;
+    queue.setHandle(fd);
+    queue.latency(latency);
+
+    const clock_t start = clock();
+
+    // Play as the emulation does, flushing once per audio buffer
+    Writes writes;
+    event_clock_t last = 0;
+    event_clock_t time = 0;
+    event_clock_t buffer = BUFFER_CYCLES;
+    for (unsigned int i = 0; i < count; i++)
+    {
+        event_clock_t gap;
+        unsigned int reg;
+        unsigned int data;
+        writes.next(gap, reg, data);
+        time += gap;
+
+        while (time >= buffer)
+        {
+            queue.delay(buffer - last);
+            queue.flush();
+            last = buffer;
+            buffer += BUFFER_CYCLES;
+        }
+
+        queue.write(time - last, reg, data);
+        last = time;
+    }
+    queue.flush();
+    close(fd);
+
+    const double elapsed = static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+
+    int status = 1;
+    waitpid(pid, &status, 0);
+    unlink(path.c_str());
+    rmdir(dir);
+
+    printf("host: %u writes, %lu write calls, %.3f s cpu, latency %u cycles\n",
+        count, queue.flushes(), elapsed, latency);
+
+    if (queue.failed())
+        fprintf(stderr, "host: write to the device failed\n");
+
+    return (!queue.failed() && WIFEXITED(status) && WEXITSTATUS(status) == 0) ? 0 : 1;
+}
@@ -0,0 +1,296 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2015 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+/*
+ * Reference SID server for the remote builder.
+ *
+ * Hosts a reSIDfp chip for each connection in a child process,
+ * so that the chips run on other cores and a crash only
+ * drops its own connection.
+ *
+ * Build with "make test/sidserver", then run
+ *     test/sidserver socket
+ * and play with a RemoteBuilder connected to the same path,
+ * e.g. test/bench -x socket tune.sid
+ */
+
+#include <stdint.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <signal.h>
+#include <errno.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <algorithm>
+#include <vector>
+
+#include "builders/residfp-builder/residfp/SID.h"
+#include "builders/remote-builder/remote-protocol.h"
+
+#include "sidcxx11.h"
+
+/*
+ * A chip serving one connection.
+ */
+class Session
+{
+private:
+    const int m_socket;
+
+    reSIDfp::SID m_sid;
+
+    /// The sampling parameters are set
+    bool m_sampling;
+
+    /// Samples not sent yet
+    std::vector<short> m_samples;
+    size_t m_count;
+
+private:
+    bool reply(const void *data, size_t size)
+    {
+        const char *p = static_cast<const char*>(data);
+        while (size > 0)
+        {
+            const ssize_t n = send(m_socket, p, size, MSG_NOSIGNAL);
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                return false;
+            }
+            p += n;
+            size -= n;
+        }
+        return true;
+    }
+
+    void run(unsigned int cycles)
+    {
+        if (cycles == 0)
+            return;
+
+        if (!m_sampling)
+        {
+            m_sid.clockSilent(cycles);
+            return;
+        }
+
+        // At most a sample for each cycle
+        if (m_samples.size() < m_count + cycles)
+            m_samples.resize(m_count + cycles);
+
+        m_count += m_sid.clock(cycles, &m_samples[m_count]);
+    }
+
+    bool sampling(uint8_t method, uint32_t clockBits, uint32_t freqBits)
+    {
+        float clock;
+        float freq;
+        memcpy(&clock, &clockBits, sizeof(clock));
+        memcpy(&freq, &freqBits, sizeof(freq));
+
+        uint32_t result = 0;
+        try
+        {
+            // As the reSIDfp builder does
+            const int halfFreq = 5000*((static_cast<int>(freq)+5000)/10000);
+            m_sid.setSamplingParameters(clock, method ? reSIDfp::RESAMPLE : reSIDfp::DECIMATE,
+                freq, std::min(halfFreq, 20000));
+            m_sampling = true;
+        }
+        catch (reSIDfp::SIDError const &)
+        {
+            result = 1;
+        }
+
+        return reply(&result, sizeof(result));
+    }
+
+    /*
+     * Execute a packet, false to close the connection.
+     */
+    bool execute(uint32_t packet)
+    {
+        const uint8_t command = (packet >> 8) & 0xff;
+        const uint8_t value = packet & 0xff;
+
+        run(packet >> 16);
+
+        if (command < 0x20)
+        {
+            m_sid.write(command, value);
+            return true;
+        }
+
+        switch (command)
+        {
+        case REMOTE_DELAY:
+            return true;
+        case REMOTE_CLOCK:
+        {
+            const uint32_t count = m_count;
+            m_count = 0;
+            return reply(&count, sizeof(count))
+                && reply(&m_samples[0], count * sizeof(short));
+        }
+        case REMOTE_READ:
+        {
+            const uint32_t data = m_sid.read(value & 0x1f);
+            return reply(&data, sizeof(data));
+        }
+        case REMOTE_RESET:
+            m_sid.reset();
+            m_sid.write(0x18, value);
+            return true;
+        case REMOTE_MODEL:
+            m_sid.setChipModel(value ? reSIDfp::MOS8580 : reSIDfp::MOS6581);
+            return true;
+        case REMOTE_VOICE:
+            m_sid.mute(value & 3, (value & 0x80) != 0);
+            return true;
+        case REMOTE_FILTER:
+            m_sid.enableFilter(value != 0);
+            return true;
+        default:
+            fprintf(stderr, "sidserver: unknown command %02x\n", command);
+            return false;
+        }
+    }
+
+public:
+    Session(int socket) :
+        m_socket(socket),
+        m_sampling(false),
+        m_count(0)
+    {
+        m_sid.setChipModel(reSIDfp::MOS6581);
+        m_sid.reset();
+    }
+
+    void serve()
+    {
+        uint8_t buffer[65536];
+        size_t size = 0;
+
+        for (;;)
+        {
+            const ssize_t n = recv(m_socket, buffer + size, sizeof(buffer) - size, 0);
+            if (n <= 0)
+            {
+                if (n < 0 && errno == EINTR)
+                    continue;
+                return;
+            }
+            size += n;
+
+            size_t pos = 0;
+            while (size - pos >= sizeof(uint32_t))
+            {
+                uint32_t packet;
+                memcpy(&packet, buffer + pos, sizeof(packet));
+
+                if (((packet >> 8) & 0xff) == REMOTE_SAMPLING)
+                {
+                    // Wait for the frequencies following the packet
+                    uint32_t frequencies[2];
+                    if (size - pos < sizeof(packet) + sizeof(frequencies))
+                        break;
+                    memcpy(frequencies, buffer + pos + sizeof(packet), sizeof(frequencies));
+
+                    run(packet >> 16);
+                    if (!sampling(packet & 0xff, frequencies[0], frequencies[1]))
+                        return;
+                    pos += sizeof(packet) + sizeof(frequencies);
+                    continue;
+                }
+
+                if (!execute(packet))
+                    return;
+                pos += sizeof(packet);
+            }
+
+            // Keep the incomplete packets for the next round
+            memmove(buffer, buffer + pos, size - pos);
+            size -= pos;
+        }
+    }
+};
+
+int main(int argc, char* argv[])
+{
+    if (argc != 2)
+    {
+        fprintf(stderr, "Usage: %s socket\n", argv[0]);
+        return -1;
+    }
+
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(argv[1]) >= sizeof(address.sun_path))
+    {
+        fprintf(stderr, "%s: socket path too long\n", argv[0]);
+        return -1;
+    }
+    strcpy(address.sun_path, argv[1]);
+
+    const int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(argv[1]);
+    if (server < 0
+        || bind(server, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0
+        || listen(server, 16) < 0)
+    {
+        perror(argv[0]);
+        return -1;
+    }
+
+    // Let the children reap themselves
+    signal(SIGCHLD, SIG_IGN);
+
+    for (;;)
+    {
+        const int client = accept(server, nullptr, nullptr);
+        if (client < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            perror(argv[0]);
+            return -1;
+        }
+
+        const pid_t pid = fork();
+        if (pid == 0)
+        {
+            close(server);
+            Session(client).serve();
+            close(client);
+            _exit(0);
+        }
+        if (pid < 0)
+            perror(argv[0]);
+
+        close(client);
+    }
+}
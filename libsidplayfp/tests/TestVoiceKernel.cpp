@@ -0,0 +1,137 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ *  Copyright (C) 2015 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "UnitTest++/UnitTest++.h"
+#include "UnitTest++/TestReporter.h"
+
+#include "../src/builders/residfp-builder/residfp/SID.h"
+
+using namespace UnitTest;
+using namespace reSIDfp;
+
+SUITE(VoiceKernel)
+{
+
+/// Control register values, biased towards the ones the kernel refuses
+const unsigned char controls[] =
+{
+    0x00, 0x01, 0x08, 0x09, 0x11, 0x15, 0x17, 0x21, 0x23, 0x41, 0x43,
+    0x81, 0x80, 0x88, 0x51, 0x61, 0x71, 0xc1, 0x91, 0xf1, 0x14, 0x40
+};
+
+struct TestFixture
+{
+    // Test setup
+    TestFixture() :
+        seed(1)
+    {
+        simd.enableSimd(true);
+    }
+
+    unsigned int random()
+    {
+        seed = seed * 1103515245 + 12345;
+        return (seed >> 16) & 0x7fff;
+    }
+
+    void setup(ChipModel model)
+    {
+        scalar.setChipModel(model);
+        simd.setChipModel(model);
+        scalar.setSamplingParameters(985248., DECIMATE, 44100., 20000.);
+        simd.setSamplingParameters(985248., DECIMATE, 44100., 20000.);
+        scalar.reset();
+        simd.reset();
+    }
+
+    /**
+     * Write a register and clock one cycle,
+     * the 8580 applies a write on the next cycle.
+     */
+    void write(int offset, unsigned char value)
+    {
+        short buf[1];
+
+        scalar.write(offset, value);
+        simd.write(offset, value);
+        scalar.clock(1, buf);
+        simd.clock(1, buf);
+    }
+
+    /**
+     * Write random values to the voice registers, clocking
+     * both chips in between, and compare their output.
+     */
+    void run(int writes)
+    {
+        short scalarBuf[4096];
+        short simdBuf[4096];
+
+        write(0x18, 0x0f);
+
+        for (int i = 0; i < writes; i++)
+        {
+            const int voice = random() % 3;
+            const int reg = random() % 7;
+
+            unsigned char value = random() & 0xff;
+            if (reg == 4)
+                value = controls[random() % (sizeof(controls) / sizeof(controls[0]))];
+
+            scalar.write(voice * 7 + reg, value);
+            simd.write(voice * 7 + reg, value);
+
+            const unsigned int cycles = 1 + random() % 8000;
+            const int scalarSamples = scalar.clock(cycles, scalarBuf);
+            const int simdSamples = simd.clock(cycles, simdBuf);
+
+            CHECK_EQUAL(scalarSamples, simdSamples);
+            CHECK_ARRAY_EQUAL(scalarBuf, simdBuf, scalarSamples);
+            CHECK_EQUAL((int)scalar.read(0x1b), (int)simd.read(0x1b));
+            CHECK_EQUAL((int)scalar.read(0x1c), (int)simd.read(0x1c));
+        }
+    }
+
+    unsigned int seed;
+
+    SID scalar;
+    SID simd;
+};
+
+TEST_FIXTURE(TestFixture, TestRandomWrites6581)
+{
+    setup(MOS6581);
+    run(5000);
+}
+
+TEST_FIXTURE(TestFixture, TestRandomWrites8580)
+{
+    setup(MOS8580);
+    run(5000);
+}
+
+TEST_FIXTURE(TestFixture, TestDisable)
+{
+    setup(MOS6581);
+    simd.enableSimd(false);
+    run(100);
+}
+
+}
@@ -358,6 +358,14 @@ int ConsolePlayer::args (int argc, const char *argv[])
             {
                 m_cpudebug = true;
             }
+            else if (strcmp (&argv[i][1], "-stats") == 0)
+            {
+                m_eventstats = true;
+            }
+            else if (strcmp (&argv[i][1], "-profile") == 0)
+            {
+                m_profile = true;
+            }
 
             else
             {
@@ -576,5 +584,7 @@ void ConsolePlayer::displayDebugArgs ()
 
         << " --noaudio     no audio output device" << endl
         << " --nosid       no sid emulation" << endl
-        << " --none        no audio output device and no sid emulation" << endl;
+        << " --none        no audio output device and no sid emulation" << endl
+        << " --profile     display a cpu profile of the tune on exit" << endl
+        << " --stats       display event scheduler statistics on exit" << endl;
 }
@@ -26,6 +26,7 @@
 
 #include <iostream>
 #include <iomanip>
+#include <vector>
 
 using std::cout;
 using std::cerr;
@@ -35,6 +36,8 @@ using std::hex;
 using std::flush;
 using std::setw;
 using std::setfill;
+using std::left;
+using std::right;
 
 #include <sidplayfp/SidInfo.h>
 #include <sidplayfp/SidTuneInfo.h>
@@ -404,6 +407,40 @@ void ConsolePlayer::consoleRestore ()
         cerr << '\x1b' << "[0m";
 }
 
+// Display the event scheduler statistics
+void ConsolePlayer::displayEventStats ()
+{
+    std::vector<EventStats> stats;
+    if (!m_engine.getEventStats (stats))
+    {
+        cerr << "Event statistics not available, rebuild libsidplayfp with --enable-event-stats" << endl;
+        return;
+    }
+
+    const std::ios_base::fmtflags flags = cerr.flags();
+    const std::streamsize precision = cerr.precision();
+
+    cerr << left << setw(34) << "Event"
+         << right << setw(14) << "Dispatches"
+         << setw(14) << "Scheduled"
+         << setw(14) << "Rescheduled"
+         << setw(12) << "Cancelled"
+         << setw(12) << "Avg depth" << endl;
+
+    for (std::vector<EventStats>::const_iterator it = stats.begin(); it != stats.end(); ++it)
+    {
+        cerr << left << setw(34) << it->name
+             << right << setw(14) << it->dispatches
+             << setw(14) << it->schedules
+             << setw(14) << it->reschedules
+             << setw(12) << it->cancels
+             << setw(12) << std::fixed << std::setprecision(2) << it->queueDepth << endl;
+    }
+
+    cerr.flags(flags);
+    cerr.precision(precision);
+}
+
 const char* ConsolePlayer::getModel (SidTuneInfo::model_t model)
 {
     switch (model)
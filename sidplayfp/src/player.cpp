@@ -135,7 +135,9 @@ ConsolePlayer::ConsolePlayer (const char * const name) :
     m_filename(""),
     m_quietLevel(0),
     m_verboseLevel(0),
-    m_cpudebug(false)
+    m_cpudebug(false),
+    m_eventstats(false),
+    m_profile(false)
 {   // Other defaults
     m_filter.enabled = true;
     m_driver.device  = NULL;
@@ -466,6 +468,9 @@ bool ConsolePlayer::open (void)
         return false;
     }
 
+    if (m_profile)
+        m_engine.profile (true);
+
     // Get tune details
     const SidTuneInfo *tuneInfo = m_tune.getInfo ();
     if (!m_track.single)
@@ -532,6 +537,11 @@ bool ConsolePlayer::open (void)
 
 void ConsolePlayer::close ()
 {
+    if (m_eventstats)
+        displayEventStats ();
+    if (m_profile)
+        m_engine.dumpProfile (stderr);
+
     m_engine.stop();
     if (m_state == playerExit)
     {   // Natural finish
@@ -126,6 +126,8 @@ private:
     uint_least8_t      m_verboseLevel;
 
     bool               m_cpudebug;
+    bool               m_eventstats;
+    bool               m_profile;
 
     bool    v1mute, v2mute, v3mute;
     bool    v4mute, v5mute, v6mute;
@@ -198,6 +200,7 @@ private:
     void updateDisplay();
     void emuflush       (void);
     void menu           (void);
+    void displayEventStats (void);
 
     const char* getModel (SidTuneInfo::model_t model);
 